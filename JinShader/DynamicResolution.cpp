@@ -0,0 +1,44 @@
+#include "DynamicResolution.h"
+#include <math.h>
+
+// Scale moves in steps so small jitter in the measurements does not reallocate the targets
+static const float scaleSteps = 20.0f;
+
+bool UpdateDynamicResolution(JinShaderDynamicResolution* resolution, float gpuMilliseconds)
+{
+	if (resolution->gpu_ms <= 0.0f)
+		resolution->gpu_ms = gpuMilliseconds;
+	resolution->gpu_ms += (gpuMilliseconds - resolution->gpu_ms) * 0.2f;
+
+	if (!resolution->enabled)
+		return false;
+	if (resolution->settle_frames > 0)
+	{
+		resolution->settle_frames--;
+		return false;
+	}
+
+	// only react outside of a band around the target, otherwise it would keep flipping
+	float budget = resolution->target_ms;
+	if (resolution->gpu_ms <= 0.0f || (resolution->gpu_ms < budget && resolution->gpu_ms > budget * 0.7f))
+		return false;
+
+	// fragment cost follows the pixel count, so each axis scales with the square root
+	float ideal = resolution->scale * sqrtf(budget * 0.85f / resolution->gpu_ms);
+	ideal = fminf(fmaxf(ideal, resolution->min_scale), 1.0f);
+	float scale = fmaxf(roundf(ideal * scaleSteps) / scaleSteps, resolution->min_scale);
+	if (scale == resolution->scale)
+		return false;
+
+	resolution->scale = scale;
+	resolution->gpu_ms = 0.0f;
+	resolution->settle_frames = 4;
+	return true;
+}
+
+void GetRenderSize(JinShaderDynamicResolution* resolution, int width, int height, int* renderWidth, int* renderHeight)
+{
+	float scale = resolution->enabled ? resolution->scale : 1.0f;
+	*renderWidth = width > 0 ? (int)fmaxf(1.0f, roundf(width * scale)) : 0;
+	*renderHeight = height > 0 ? (int)fmaxf(1.0f, roundf(height * scale)) : 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Scales the internal render resolution so the shader passes fit a GPU time budget. The View
+// window stretches the smaller image back up when drawing it.
+struct JinShaderDynamicResolution
+{
+	bool enabled = false;
+	float target_ms = 16.6f;
+	float min_scale = 0.25f;
+
+	float scale = 1.0f;		// of the View size, per axis
+	float gpu_ms = 0.0f;		// smoothed measurement
+	int settle_frames = 0;	// measurements to ignore after a change, the old size is still in flight
+};
+
+// Feeds one GPU time measurement of the shader passes. Returns true when scale changed and the
+// render targets need to be resized.
+bool UpdateDynamicResolution(JinShaderDynamicResolution* resolution, float gpuMilliseconds);
+
+// Internal size for a View of width x height
+void GetRenderSize(JinShaderDynamicResolution* resolution, int width, int height, int* renderWidth, int* renderHeight);
@@ -0,0 +1,56 @@
+#include "GpuTimer.h"
+#include <GL/glew.h>
+
+void InitGpuTimer(GpuTimer* timer)
+{
+	glGenQueries(gpuTimerQueryCount, timer->queries);
+	timer->write = timer->read = 0;
+	timer->running = false;
+}
+
+void ShutdownGpuTimer(GpuTimer* timer)
+{
+	glDeleteQueries(gpuTimerQueryCount, timer->queries);
+	*timer = GpuTimer();
+}
+
+void BeginGpuTimer(GpuTimer* timer)
+{
+	if (timer->write - timer->read == gpuTimerQueryCount)
+		return;
+	glBeginQuery(GL_TIME_ELAPSED, timer->queries[timer->write % gpuTimerQueryCount]);
+	timer->running = true;
+}
+
+void EndGpuTimer(GpuTimer* timer, bool keep)
+{
+	if (!timer->running)
+		return;
+	glEndQuery(GL_TIME_ELAPSED);
+	timer->keep[timer->write % gpuTimerQueryCount] = keep;
+	timer->write++;
+	timer->running = false;
+}
+
+bool PollGpuTimer(GpuTimer* timer, float* milliseconds)
+{
+	while (timer->read < timer->write)
+	{
+		unsigned int query = timer->queries[timer->read % gpuTimerQueryCount];
+		int available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+		bool keep = timer->keep[timer->read % gpuTimerQueryCount];
+		timer->read++;
+		if (keep)
+		{
+			*milliseconds = (float)(elapsed / 1000000.0);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+const int gpuTimerQueryCount = 4;
+
+// GL_TIME_ELAPSED queries in a small ring, so reading a result never waits on the GPU.
+// Results arrive a few frames late, frames are skipped while every query is still in flight.
+struct GpuTimer
+{
+	unsigned int queries[gpuTimerQueryCount] = {};
+	bool keep[gpuTimerQueryCount] = {};
+	int write = 0;		// queries issued
+	int read = 0;		// queries collected
+	bool running = false;
+};
+
+void InitGpuTimer(GpuTimer* timer);
+void ShutdownGpuTimer(GpuTimer* timer);
+
+void BeginGpuTimer(GpuTimer* timer);
+// keep = false drops the measurement, e.g. when nothing was drawn after all
+void EndGpuTimer(GpuTimer* timer, bool keep = true);
+
+// Returns true with the oldest finished measurement in milliseconds
+bool PollGpuTimer(GpuTimer* timer, float* milliseconds);
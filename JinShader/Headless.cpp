@@ -0,0 +1,279 @@
+#include "Headless.h"
+#include "JinShader.h"
+#include "Renderer.h"
+#include "ProgramCache.h"
+#include "TextureLoader.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+static void PrintUsage()
+{
+	printf("Usage: JinShader --render shader.glsl [--size WIDTHxHEIGHT] [--frames N] [--fps N] [--out dir] [--channel0-3 image.png]\n");
+}
+
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions* options, bool* error)
+{
+	*error = false;
+	bool render = false;
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (arg == "--render" && hasValue)
+		{
+			render = true;
+			options->shader_path = argv[++i];
+		}
+		else if (arg == "--size" && hasValue)
+		{
+			if (sscanf(argv[++i], "%dx%d", &options->width, &options->height) != 2 || options->width <= 0 || options->height <= 0)
+				*error = true;
+		}
+		else if (arg == "--frames" && hasValue)
+		{
+			options->frames = atoi(argv[++i]);
+			if (options->frames <= 0)
+				*error = true;
+		}
+		else if (arg == "--fps" && hasValue)
+		{
+			options->fps = (float)atof(argv[++i]);
+			if (options->fps <= 0.0f)
+				*error = true;
+		}
+		else if (arg == "--out" && hasValue)
+		{
+			options->out_dir = argv[++i];
+		}
+		else if (arg.size() == 10 && arg.compare(0, 9, "--channel") == 0 && arg[9] >= '0' && arg[9] < '0' + renderChannelCount && hasValue)
+		{
+			options->channel_paths[arg[9] - '0'] = argv[++i];
+		}
+		else
+		{
+			*error = true;
+		}
+	}
+
+	if (!render && argc > 1)
+		*error = true;
+	if (*error)
+		PrintUsage();
+	return render || *error;
+}
+
+static uint32_t Crc32(uint32_t crc, const unsigned char* data, size_t len)
+{
+	static uint32_t table[256];
+	if (!table[1])
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			table[i] = c;
+		}
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < len; i++)
+		crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void PutU32(std::vector<unsigned char>& out, uint32_t v)
+{
+	out.push_back((unsigned char)(v >> 24));
+	out.push_back((unsigned char)(v >> 16));
+	out.push_back((unsigned char)(v >> 8));
+	out.push_back((unsigned char)v);
+}
+
+static void PutChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+{
+	std::vector<unsigned char> chunk;
+	PutU32(chunk, (uint32_t)data.size());
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	uint32_t crc = Crc32(0, chunk.data() + 4, chunk.size() - 4);
+	PutU32(chunk, crc);
+	file.write((const char*)chunk.data(), chunk.size());
+}
+
+// Writes an RGBA8 image (bottom row first, as read from GL) to an uncompressed PNG.
+// Previews are converted/compressed by whatever consumes them, so we keep this dependency free.
+static bool WritePNG(const std::string& path, int width, int height, const unsigned char* pixels)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	file.write((const char*)signature, 8);
+
+	std::vector<unsigned char> header;
+	PutU32(header, width);
+	PutU32(header, height);
+	header.push_back(8);	// bit depth
+	header.push_back(6);	// RGBA
+	header.push_back(0);
+	header.push_back(0);
+	header.push_back(0);
+	PutChunk(file, "IHDR", header);
+
+	// scanlines with filter type 0, flipped so the top row comes first
+	size_t stride = (size_t)width * 4;
+	std::vector<unsigned char> raw;
+	raw.reserve((stride + 1) * height);
+	for (int y = height - 1; y >= 0; y--)
+	{
+		raw.push_back(0);
+		raw.insert(raw.end(), pixels + y * stride, pixels + (y + 1) * stride);
+	}
+
+	// zlib stream made of stored deflate blocks
+	std::vector<unsigned char> idat;
+	idat.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+	idat.push_back(0x78);
+	idat.push_back(0x01);
+	uint32_t a = 1, b = 0;
+	for (size_t offset = 0; ; )
+	{
+		size_t len = std::min<size_t>(65535, raw.size() - offset);
+		bool last = offset + len == raw.size();
+		idat.push_back(last ? 1 : 0);
+		idat.push_back((unsigned char)len);
+		idat.push_back((unsigned char)(len >> 8));
+		idat.push_back((unsigned char)~len);
+		idat.push_back((unsigned char)(~len >> 8));
+		idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + len);
+		for (size_t i = offset; i < offset + len; i++)
+		{
+			a = (a + raw[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		offset += len;
+		if (last)
+			break;
+	}
+	PutU32(idat, (b << 16) | a);
+	PutChunk(file, "IDAT", idat);
+	PutChunk(file, "IEND", {});
+	return (bool)file;
+}
+
+int RunHeadless(const HeadlessOptions& options)
+{
+	std::ifstream shaderFile(options.shader_path, std::ios::binary);
+	if (!shaderFile)
+	{
+		printf("Cannot open shader %s\n", options.shader_path.c_str());
+		return 1;
+	}
+	std::stringstream code;
+	code << shaderFile.rdbuf();
+
+	std::error_code ec;
+	std::filesystem::create_directories(options.out_dir, ec);
+	if (ec)
+	{
+		printf("Cannot create output directory %s : %s\n", options.out_dir.c_str(), ec.message().c_str());
+		return 1;
+	}
+
+	JinShaderState* state = InitJinShader();
+	if (!InitHeadlessContext(state))
+		return 2;
+
+	printf("Renderer: %s\n", glGetString(GL_RENDERER));
+
+	JinShaderRenderer renderer;
+	InitRenderer(&renderer);
+	JinShaderTextureLoader textureLoader;
+	InitTextureLoader(&textureLoader);
+
+	// preview farms re-render the same shaders a lot, so reuse program binaries across runs
+	JinShaderProgramCache programCache;
+	InitProgramCache(&programCache, GetProgramCacheDirectory().c_str(), 1);
+	uint64_t key = HashShaderSource(&programCache, code.str());
+
+	int exitCode = 0;
+	CompiledProgram compiled;
+	if (LoadProgramBinary(programCache.directory, key, &compiled.program))
+	{
+		compiled.success = true;
+		printf("Loaded program binary from %s\n", programCache.directory.c_str());
+	}
+	else
+	{
+		BuildShaderProgram(renderer.stages, code.str().c_str(), &compiled);
+		if (compiled.success)
+			SaveProgramBinary(programCache.directory, key, compiled.program);
+	}
+
+	if (!compiled.success)
+	{
+		printf("Shader %s Failed! : %s\n", compiled.compile_failed ? "Compilation" : "Link", compiled.log.c_str());
+		exitCode = 3;
+	}
+	else
+	{
+		SetPassProgram(&renderer, RenderPass_Image, compiled.program, FindShaderInputs(code.str().c_str()));
+		ResizeRenderTarget(&renderer, options.width, options.height);
+
+		// frames have to be exact here, so wait until every image is on the GPU
+		for (int c = 0; c < renderChannelCount; c++)
+		{
+			if (options.channel_paths[c].empty())
+				continue;
+			SetPassChannelTexture(&renderer, RenderPass_Image, c, LoadChannelTexture(&textureLoader, options.channel_paths[c]));
+			SetPassChannelSampler(&renderer, RenderPass_Image, c, ChannelFilter_Mipmap, ChannelWrap_Repeat);
+		}
+		while (IsTextureLoaderBusy(&textureLoader))
+		{
+			UpdateTextureLoader(&textureLoader);
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		std::string textureError;
+		while (PollTextureError(&textureLoader, &textureError))
+		{
+			printf("Failed to load texture %s\n", textureError.c_str());
+			exitCode = 1;
+		}
+		std::vector<unsigned char> pixels((size_t)options.width * options.height * 4);
+
+		ShaderInputs inputs;
+		inputs.time_delta = 1.0f / options.fps;
+		for (int frame = 0; frame < options.frames && exitCode == 0; frame++)
+		{
+			inputs.frame = frame;
+			inputs.time = frame * inputs.time_delta;
+			inputs.date[3] = inputs.time;
+			RenderShader(&renderer, inputs);
+			ReadRenderTarget(&renderer, pixels.data());
+
+			char name[32];
+			snprintf(name, sizeof(name), "frame_%05d.png", frame);
+			auto path = (std::filesystem::path(options.out_dir) / name).string();
+			if (!WritePNG(path, options.width, options.height, pixels.data()))
+			{
+				printf("Failed to write %s\n", path.c_str());
+				exitCode = 4;
+				break;
+			}
+		}
+		if (exitCode == 0)
+			printf("Rendered %d frames to %s\n", options.frames, options.out_dir.c_str());
+	}
+
+	DeleteCompiledProgram(&compiled);
+	ShutdownTextureLoader(&textureLoader);
+	ShutdownRenderer(&renderer);
+	ShutdownHeadlessContext(state);
+	delete state;
+	return exitCode;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "Renderer.h"
+#include <string>
+
+// Options for `JinShader --render shader.glsl --size 1920x1080 --frames 600 --out dir/`
+struct HeadlessOptions
+{
+	std::string shader_path;
+	std::string out_dir = ".";
+	int width = 1280, height = 720;
+	int frames = 1;
+	float fps = 60.0f;
+	std::string channel_paths[renderChannelCount];	// --channel0 noise.png, images for the Image pass
+};
+
+// Returns true when the command line asks for a headless render, options are filled in.
+// Malformed arguments print usage and set *error.
+bool ParseHeadlessOptions(int argc, char** argv, HeadlessOptions* options, bool* error);
+
+// Renders the frames to <out_dir>/frame_00000.png ... with no window and no ImGui.
+// Returns the process exit code.
+int RunHeadless(const HeadlessOptions& options);
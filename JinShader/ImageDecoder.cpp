@@ -0,0 +1,210 @@
+#include "ImageDecoder.h"
+#include <stdint.h>
+#include <string.h>
+
+static const unsigned int maxImageSize = 16384;
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <wincodec.h>
+#pragma comment(lib, "windowscodecs.lib")
+
+static bool DecodeWithWic(const std::string& path, DecodedImage* image, std::string* error)
+{
+	int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, NULL, 0);
+	std::wstring widePath(wideLength > 0 ? wideLength : 1, L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+
+	IWICImagingFactory* factory = 0;
+	IWICBitmapDecoder* decoder = 0;
+	IWICBitmapFrameDecode* frame = 0;
+	IWICBitmapSource* converted = 0;
+	HRESULT hr = CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+	if (SUCCEEDED(hr))
+		hr = factory->CreateDecoderFromFilename(widePath.c_str(), NULL, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+	if (SUCCEEDED(hr))
+		hr = decoder->GetFrame(0, &frame);
+	if (SUCCEEDED(hr))
+		hr = WICConvertBitmapSource(GUID_WICPixelFormat32bppRGBA, frame, &converted);
+
+	UINT width = 0, height = 0;
+	if (SUCCEEDED(hr))
+		hr = converted->GetSize(&width, &height);
+	bool tooLarge = SUCCEEDED(hr) && (width > maxImageSize || height > maxImageSize);
+	if (SUCCEEDED(hr) && !tooLarge)
+	{
+		image->width = (int)width;
+		image->height = (int)height;
+		image->pixels.resize((size_t)width * height * 4);
+		hr = converted->CopyPixels(NULL, width * 4, (UINT)image->pixels.size(), image->pixels.data());
+	}
+
+	if (converted)
+		converted->Release();
+	if (frame)
+		frame->Release();
+	if (decoder)
+		decoder->Release();
+	if (factory)
+		factory->Release();
+
+	if (tooLarge)
+	{
+		*error = "Image is too large";
+		return false;
+	}
+	if (FAILED(hr))
+	{
+		char code[16];
+		snprintf(code, sizeof(code), "0x%08lx", (unsigned long)hr);
+		*error = "Cannot decode image, HRESULT " + std::string(code);
+		*image = DecodedImage();
+		return false;
+	}
+	return true;
+}
+
+bool DecodeImageFile(const std::string& path, DecodedImage* image, std::string* error)
+{
+	// the decode worker has no other use for COM, so it only lives as long as one decode
+	HRESULT init = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+	bool success = DecodeWithWic(path, image, error);
+	if (SUCCEEDED(init))
+		CoUninitialize();
+	return success;
+}
+
+#else
+#include <png.h>
+#include <jpeglib.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
+
+static bool DecodePng(const std::vector<unsigned char>& file, DecodedImage* image, std::string* error)
+{
+	png_image png;
+	memset(&png, 0, sizeof(png));
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_memory(&png, file.data(), file.size()))
+	{
+		*error = png.message;
+		return false;
+	}
+	if (png.width > maxImageSize || png.height > maxImageSize)
+	{
+		png_image_free(&png);
+		*error = "Image is too large";
+		return false;
+	}
+
+	png.format = PNG_FORMAT_RGBA;
+	image->width = (int)png.width;
+	image->height = (int)png.height;
+	image->pixels.resize(PNG_IMAGE_SIZE(png));
+	// frees png whether it succeeds or not
+	if (!png_image_finish_read(&png, NULL, image->pixels.data(), 0, NULL))
+	{
+		*error = png.message;
+		*image = DecodedImage();
+		return false;
+	}
+	return true;
+}
+
+struct JpegError
+{
+	jpeg_error_mgr manager;
+	jmp_buf jump;
+	char message[JMSG_LENGTH_MAX];
+};
+
+static void JpegErrorExit(j_common_ptr info)
+{
+	JpegError* jpegError = (JpegError*)info->err;
+	info->err->format_message(info, jpegError->message);
+	longjmp(jpegError->jump, 1);
+}
+
+static void JpegIgnoreMessage(j_common_ptr)
+{
+}
+
+// Everything that needs destroying lives outside, libjpeg errors longjmp out of here
+static bool DecodeJpeg(const std::vector<unsigned char>& file, jpeg_decompress_struct* info, std::vector<unsigned char>* row, DecodedImage* image, std::string* error)
+{
+	jpeg_mem_src(info, file.data(), (unsigned long)file.size());
+	jpeg_read_header(info, TRUE);
+	if (info->image_width > maxImageSize || info->image_height > maxImageSize)
+	{
+		*error = "Image is too large";
+		return false;
+	}
+
+	info->out_color_space = JCS_RGB;
+	jpeg_start_decompress(info);
+	int width = (int)info->output_width;
+	int height = (int)info->output_height;
+	row->resize((size_t)width * 3);
+	image->width = width;
+	image->height = height;
+	image->pixels.resize((size_t)width * height * 4);
+	while ((int)info->output_scanline < height)
+	{
+		unsigned char* rgb = row->data();
+		unsigned char* rgba = image->pixels.data() + (size_t)info->output_scanline * width * 4;
+		jpeg_read_scanlines(info, &rgb, 1);
+		for (int x = 0; x < width; x++)
+		{
+			rgba[x * 4 + 0] = rgb[x * 3 + 0];
+			rgba[x * 4 + 1] = rgb[x * 3 + 1];
+			rgba[x * 4 + 2] = rgb[x * 3 + 2];
+			rgba[x * 4 + 3] = 255;
+		}
+	}
+	jpeg_finish_decompress(info);
+	return true;
+}
+
+bool DecodeImageFile(const std::string& path, DecodedImage* image, std::string* error)
+{
+	std::ifstream stream(path, std::ios::binary);
+	if (!stream)
+	{
+		*error = "Cannot open " + path;
+		return false;
+	}
+	std::vector<unsigned char> file((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+	static const unsigned char pngSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	if (file.size() >= 8 && memcmp(file.data(), pngSignature, 8) == 0)
+		return DecodePng(file, image, error);
+	if (file.size() < 3 || file[0] != 0xff || file[1] != 0xd8 || file[2] != 0xff)
+	{
+		*error = "Unsupported image format, expected PNG or JPEG";
+		return false;
+	}
+
+	jpeg_decompress_struct info;
+	JpegError jpegError;
+	std::vector<unsigned char> row;
+	info.err = jpeg_std_error(&jpegError.manager);
+	jpegError.manager.error_exit = JpegErrorExit;
+	jpegError.manager.output_message = JpegIgnoreMessage;
+	jpeg_create_decompress(&info);
+	if (setjmp(jpegError.jump) != 0)
+	{
+		*error = jpegError.message;
+		jpeg_destroy_decompress(&info);
+		*image = DecodedImage();
+		return false;
+	}
+	bool success = DecodeJpeg(file, &info, &row, image, error);
+	jpeg_destroy_decompress(&info);
+	if (!success)
+		*image = DecodedImage();
+	return success;
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Decoded image as tightly packed RGBA8, top row first
+struct DecodedImage
+{
+	int width = 0, height = 0;
+	std::vector<unsigned char> pixels;
+};
+
+// Reads and decodes an image file with the platform codecs: WIC on Windows (PNG, JPEG, BMP, GIF,
+// TIFF and whatever else is installed), libpng and libjpeg elsewhere.
+// Pure CPU work, safe to call from any thread.
+bool DecodeImageFile(const std::string& path, DecodedImage* image, std::string* error);
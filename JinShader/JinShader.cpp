@@ -1,5 +1,10 @@
 #include "JinShader.h"
 
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
 {
@@ -69,6 +74,157 @@ void InitImGui(JinShaderState* state)
 
 void JinShaderUpdate(JinShaderState* state)
 {
-	glfwPollEvents();
+	if (state->redraw_frames > 0 || (state->animating && state->has_focus))
+	{
+		// vsync in glfwSwapBuffers paces these frames
+		glfwPollEvents();
+		if (state->redraw_frames > 0)
+			state->redraw_frames--;
+	}
+	else
+	{
+		bool throttled = state->animating && state->background_fps > 0.0f;
+		double start = glfwGetTime();
+		double timeout = throttled ? state->last_frame_time + 1.0 / state->background_fps - start : 0.0;
+		if (state->wake_time > 0.0 && (!throttled || state->wake_time - start < timeout))
+		{
+			throttled = true;
+			timeout = state->wake_time - start;
+		}
+		if (!throttled)
+			glfwWaitEvents();
+		else if (timeout > 0.0)
+			glfwWaitEventsTimeout(timeout);
+		else
+			glfwPollEvents();
+
+		// woken by an event rather than the timeout, ImGui needs a couple of frames to settle hover and popups
+		if (!throttled || glfwGetTime() - start < timeout)
+			state->redraw_frames = 2;
+	}
+
+	state->last_frame_time = glfwGetTime();
 	state->window_is_open = !glfwWindowShouldClose(state->window);
 }
+
+GLFWwindow* CreateSharedContext(JinShaderState* state)
+{
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(1, 1, "JinShader Worker", 0, state->window);
+	glfwDefaultWindowHints();
+	return window;
+}
+
+
+#if defined(__linux__)
+bool InitHeadlessContext(JinShaderState* state)
+{
+	state->headless = true;
+
+	// Prefer the Mesa surfaceless platform so no X11/Wayland session is needed
+	EGLDisplay display = EGL_NO_DISPLAY;
+	auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+		display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+	EGLint major = 0, minor = 0;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+	{
+		printf("Failed to Init EGL! Cannot Continue!\n");
+		return false;
+	}
+
+	const EGLint configAttribs[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0)
+	{
+		printf("Failed to find an EGL config for OpenGL! Cannot Continue!\n");
+		eglTerminate(display);
+		return false;
+	}
+
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, 0);
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		printf("Failed to create EGL context! Cannot Continue!\n");
+		eglTerminate(display);
+		return false;
+	}
+
+	state->egl_display = display;
+	state->egl_context = context;
+
+	// glewInit() also initializes GLX, which has no display here, so only load the GL entry points
+	glewExperimental = true;
+	if (glewContextInit() != GLEW_OK)
+	{
+		printf("Failed to Init GLEW! Cannot Continue!\n");
+		ShutdownHeadlessContext(state);
+		return false;
+	}
+	return true;
+}
+
+void ShutdownHeadlessContext(JinShaderState* state)
+{
+	if (state->egl_display)
+	{
+		eglMakeCurrent(state->egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (state->egl_context)
+			eglDestroyContext(state->egl_display, state->egl_context);
+		eglTerminate(state->egl_display);
+	}
+	state->egl_display = 0;
+	state->egl_context = 0;
+}
+#else
+bool InitHeadlessContext(JinShaderState* state)
+{
+	state->headless = true;
+
+	if (!glfwInit())
+	{
+		printf("Failed to Init GLFW! Cannot Continue!\n");
+		return false;
+	}
+
+	// No EGL here, an invisible window still gives us a context without showing anything
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	state->window = glfwCreateWindow(64, 64, "JinShader", 0, 0);
+	if (!state->window)
+	{
+		printf("Failed to create a hidden window! Cannot Continue!\n");
+		glfwTerminate();
+		return false;
+	}
+	glfwMakeContextCurrent(state->window);
+	glewExperimental = true;
+	if (glewInit() != GLEW_OK)
+	{
+		printf("Failed to Init GLEW! Cannot Continue!\n");
+		ShutdownHeadlessContext(state);
+		return false;
+	}
+	return true;
+}
+
+void ShutdownHeadlessContext(JinShaderState* state)
+{
+	if (state->window)
+		glfwDestroyWindow(state->window);
+	glfwTerminate();
+	state->window = 0;
+}
+#endif
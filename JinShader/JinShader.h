@@ -17,9 +17,30 @@ struct JinShaderState
 	bool compile_success = false;
 	bool has_focus = true;
 	bool window_is_open;
+
+	// frame scheduling, see JinShaderUpdate
+	bool animating = true;			// something on screen changes with time
+	float background_fps = 10.0f;	// frame rate while unfocused, 0 only redraws on events
+	int redraw_frames = 0;			// frames left to draw after an event
+	double wake_time = 0.0;			// glfwGetTime deadline to wake up by even without events, 0 for none
+	double last_frame_time = 0.0;
+	bool headless = false;
+	void* egl_display = 0;
+	void* egl_context = 0;
 };
 
 JinShaderState* InitJinShader();
 void InitWindow(JinShaderState* state);
 void InitImGui(JinShaderState* state);
-void JinShaderUpdate(JinShaderState* state);
\ No newline at end of file
+// Waits for the next frame and polls events. Runs at the swap interval while focused and
+// animating, at background_fps while unfocused, and sleeps until an event otherwise.
+// Any thread can wake it early with glfwPostEmptyEvent(), and it never sleeps past wake_time.
+void JinShaderUpdate(JinShaderState* state);
+
+// Hidden window whose context shares objects with state->window, for use on worker threads
+GLFWwindow* CreateSharedContext(JinShaderState* state);
+
+// Creates a GL context with no visible window for offline rendering.
+// Uses a surfaceless EGL display on Linux (works with Mesa llvmpipe) and a hidden GLFW window elsewhere.
+bool InitHeadlessContext(JinShaderState* state);
+void ShutdownHeadlessContext(JinShaderState* state);
\ No newline at end of file
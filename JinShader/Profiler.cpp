@@ -0,0 +1,124 @@
+#include "Profiler.h"
+#include "Trace.h"
+#include "imgui/imgui.h"
+#include <algorithm>
+
+const char* profileZoneNames[ProfileZone_Count] = { "Frame", "ImGui Build", "Editor", "Colorize", "Compile", "Shader Pass", "UI Draw", "Swap Wait" };
+
+static void PushSample(ProfileSeries* series, float milliseconds)
+{
+	series->samples[series->head] = milliseconds;
+	series->head = (series->head + 1) % profileHistory;
+	if (series->count < profileHistory)
+		series->count++;
+}
+
+void BeginProfileZone(JinShaderProfiler* profiler, int zone)
+{
+	profiler->zone_start[zone] = GetTraceTime();
+}
+
+void EndProfileZone(JinShaderProfiler* profiler, int zone)
+{
+	uint64_t now = GetTraceTime();
+	profiler->frame_cpu[zone] += (now - profiler->zone_start[zone]) / 1000000.0f;
+	AddTraceEvent(profileZoneNames[zone], profiler->zone_start[zone], now);
+}
+
+void AddProfileTime(JinShaderProfiler* profiler, int zone, float milliseconds)
+{
+	profiler->frame_cpu[zone] += milliseconds;
+}
+
+void AddGpuProfileTime(JinShaderProfiler* profiler, int zone, float milliseconds)
+{
+	if (!profiler->paused)
+		PushSample(&profiler->gpu[zone], milliseconds);
+}
+
+void EndProfileFrame(JinShaderProfiler* profiler)
+{
+	if (!profiler->paused)
+		for (int i = 0; i < ProfileZone_Count; i++)
+			PushSample(&profiler->cpu[i], profiler->frame_cpu[i]);
+	for (auto& time : profiler->frame_cpu)
+		time = 0.0f;
+}
+
+// p50, p95, p99 and max of the history
+static void GetPercentiles(const ProfileSeries* series, float* stats)
+{
+	float sorted[profileHistory];
+	std::copy(series->samples, series->samples + series->count, sorted);
+	std::sort(sorted, sorted + series->count);
+	const float points[3] = { 0.50f, 0.95f, 0.99f };
+	for (int i = 0; i < 3; i++)
+		stats[i] = series->count ? sorted[(int)(points[i] * (series->count - 1) + 0.5f)] : 0.0f;
+	stats[3] = series->count ? sorted[series->count - 1] : 0.0f;
+}
+
+static float LastSample(const ProfileSeries* series)
+{
+	return series->count ? series->samples[(series->head + profileHistory - 1) % profileHistory] : 0.0f;
+}
+
+static void DrawSeriesRow(const char* name, const char* kind, const ProfileSeries* series)
+{
+	float stats[4];
+	GetPercentiles(series, stats);
+	ImGui::TableNextRow();
+	ImGui::TableNextColumn();
+	ImGui::Text("%s", name);
+	ImGui::TableNextColumn();
+	ImGui::TextDisabled("%s", kind);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.2f", LastSample(series));
+	for (float stat : stats)
+	{
+		ImGui::TableNextColumn();
+		ImGui::Text("%.2f", stat);
+	}
+	ImGui::TableNextColumn();
+
+	// oldest sample first, so the graph scrolls to the left
+	int offset = series->count < profileHistory ? 0 : series->head;
+	ImGui::PushID(series);
+	ImGui::SetNextItemWidth(-FLT_MIN);
+	ImGui::PlotLines("##history", series->samples, series->count, offset, 0, 0.0f, std::max(stats[3], 1.0f), ImVec2(0, ImGui::GetTextLineHeight()));
+	ImGui::PopID();
+}
+
+void DrawProfiler(JinShaderProfiler* profiler, bool* open)
+{
+	if (!ImGui::Begin("Profiler", open))
+	{
+		ImGui::End();
+		return;
+	}
+
+	ImGui::Checkbox("Pause", &profiler->paused);
+	ImGui::SameLine();
+	ImGui::TextDisabled("milliseconds over the last %d frames", profileHistory);
+
+	ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit;
+	if (ImGui::BeginTable("Zones", 8, flags))
+	{
+		ImGui::TableSetupColumn("Zone");
+		ImGui::TableSetupColumn("");
+		ImGui::TableSetupColumn("Last");
+		ImGui::TableSetupColumn("p50");
+		ImGui::TableSetupColumn("p95");
+		ImGui::TableSetupColumn("p99");
+		ImGui::TableSetupColumn("Max");
+		ImGui::TableSetupColumn("History", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableHeadersRow();
+		for (int i = 0; i < ProfileZone_Count; i++)
+		{
+			DrawSeriesRow(profileZoneNames[i], "CPU", &profiler->cpu[i]);
+			if (profiler->gpu[i].count)
+				DrawSeriesRow(profileZoneNames[i], "GPU", &profiler->gpu[i]);
+		}
+		ImGui::EndTable();
+	}
+	ImGui::End();
+}
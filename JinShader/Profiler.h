@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// Phases of a frame in the main loop. Zones nest, Editor includes Colorize and ImGui Build
+// includes both, so the rows do not add up to Frame.
+enum ProfileZone
+{
+	ProfileZone_Frame,
+	ProfileZone_ImGuiBuild,
+	ProfileZone_Editor,
+	ProfileZone_Colorize,
+	ProfileZone_Compile,		// worker thread, counted in the frame that receives the result
+	ProfileZone_ShaderPass,
+	ProfileZone_UIDraw,
+	ProfileZone_SwapWait,
+	ProfileZone_Count
+};
+
+extern const char* profileZoneNames[ProfileZone_Count];
+
+const int profileHistory = 240;
+
+// Rolling window of the last profileHistory samples
+struct ProfileSeries
+{
+	float samples[profileHistory] = {};
+	int count = 0;
+	int head = 0;		// next write
+};
+
+struct JinShaderProfiler
+{
+	ProfileSeries cpu[ProfileZone_Count];
+	ProfileSeries gpu[ProfileZone_Count];	// only zones fed with AddGpuProfileTime
+	float frame_cpu[ProfileZone_Count] = {};	// accumulated until EndProfileFrame
+	uint64_t zone_start[ProfileZone_Count] = {};	// GetTraceTime
+	bool paused = false;
+};
+
+// Zones are also recorded in the trace, see Trace.h
+void BeginProfileZone(JinShaderProfiler* profiler, int zone);
+void EndProfileZone(JinShaderProfiler* profiler, int zone);
+// For time measured elsewhere, e.g. on another thread
+void AddProfileTime(JinShaderProfiler* profiler, int zone, float milliseconds);
+// GPU results arrive a few frames late, they go straight into the history
+void AddGpuProfileTime(JinShaderProfiler* profiler, int zone, float milliseconds);
+// Pushes this frame's CPU times into the history
+void EndProfileFrame(JinShaderProfiler* profiler);
+
+void DrawProfiler(JinShaderProfiler* profiler, bool* open);
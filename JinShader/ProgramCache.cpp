@@ -0,0 +1,212 @@
+#include "ProgramCache.h"
+#include "Renderer.h"
+#include "Trace.h"
+#include <GL/glew.h>
+#include <stdlib.h>
+#include <string.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+static const uint32_t programBinaryMagic = 0x4250534a;	// "JSPB"
+
+static uint64_t Fnv1a(uint64_t hash, const char* data, size_t len)
+{
+	for (size_t i = 0; i < len; i++)
+	{
+		hash ^= (unsigned char)data[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static std::string BinaryPath(const std::string& directory, uint64_t key)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+	return (std::filesystem::path(directory) / name).string();
+}
+
+std::string GetProgramCacheDirectory()
+{
+#ifdef _WIN32
+	const char* localAppData = getenv("LOCALAPPDATA");
+	if (localAppData && *localAppData)
+		return (std::filesystem::path(localAppData) / "JinShader" / "shadercache").string();
+#else
+	const char* xdgCache = getenv("XDG_CACHE_HOME");
+	if (xdgCache && *xdgCache)
+		return (std::filesystem::path(xdgCache) / "jinshader").string();
+	const char* home = getenv("HOME");
+	if (home && *home)
+		return (std::filesystem::path(home) / ".cache" / "jinshader").string();
+#endif
+	return std::string();
+}
+
+void InitProgramCache(JinShaderProgramCache* cache, const char* directory, int capacity)
+{
+	cache->capacity = capacity > 0 ? capacity : 1;
+
+	// a binary is only valid for the driver that produced it
+	uint64_t hash = 0xcbf29ce484222325ull;
+	GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	for (auto name : names)
+	{
+		auto str = (const char*)glGetString(name);
+		if (str)
+			hash = Fnv1a(hash, str, strlen(str) + 1);
+	}
+	cache->driver_hash = hash;
+
+	cache->directory.clear();
+	if (directory && *directory && GLEW_ARB_get_program_binary)
+	{
+		int formats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+		std::error_code ec;
+		std::filesystem::create_directories(directory, ec);
+		if (formats > 0 && !ec)
+			cache->directory = directory;
+	}
+}
+
+void ShutdownProgramCache(JinShaderProgramCache* cache)
+{
+	for (auto& entry : cache->entries)
+		glDeleteProgram(entry.program);
+	cache->entries.clear();
+	cache->lookup.clear();
+}
+
+uint64_t HashShaderSource(JinShaderProgramCache* cache, const std::string& code)
+{
+	uint64_t hash = Fnv1a(cache->driver_hash, commonShaderSource, strlen(commonShaderSource));
+	hash = Fnv1a(hash, mainShaderSource, strlen(mainShaderSource));
+	// linked into every program too, so a changed vertex stage must miss the binaries on disk
+	hash = Fnv1a(hash, vertexShaderSource, strlen(vertexShaderSource));
+	return Fnv1a(hash, code.data(), code.size());
+}
+
+unsigned int FindCachedProgram(JinShaderProgramCache* cache, uint64_t key)
+{
+	auto it = cache->lookup.find(key);
+	if (it == cache->lookup.end())
+		return 0;
+	cache->entries.splice(cache->entries.begin(), cache->entries, it->second);
+	return it->second->program;
+}
+
+void AddCachedProgram(JinShaderProgramCache* cache, uint64_t key, unsigned int program)
+{
+	auto it = cache->lookup.find(key);
+	if (it != cache->lookup.end())
+	{
+		if (it->second->program != program)
+			glDeleteProgram(it->second->program);
+		it->second->program = program;
+		cache->entries.splice(cache->entries.begin(), cache->entries, it->second);
+		return;
+	}
+
+	cache->entries.push_front({ key, program, 0 });
+	cache->lookup[key] = cache->entries.begin();
+
+	// with too many pins the cache stays over capacity, the new entry is never the one to go
+	auto last = std::prev(cache->entries.end());
+	while ((int)cache->entries.size() > cache->capacity && last != cache->entries.begin())
+	{
+		auto victim = last--;
+		if (victim->pins > 0)
+			continue;
+		glDeleteProgram(victim->program);
+		cache->lookup.erase(victim->key);
+		cache->entries.erase(victim);
+	}
+}
+
+void PinCachedProgram(JinShaderProgramCache* cache, uint64_t key)
+{
+	auto it = cache->lookup.find(key);
+	if (it != cache->lookup.end())
+		it->second->pins++;
+}
+
+void UnpinCachedProgram(JinShaderProgramCache* cache, uint64_t key)
+{
+	auto it = cache->lookup.find(key);
+	if (it != cache->lookup.end() && it->second->pins > 0)
+		it->second->pins--;
+}
+
+bool LoadProgramBinary(const std::string& directory, uint64_t key, unsigned int* program)
+{
+	if (directory.empty())
+		return false;
+
+	std::ifstream file(BinaryPath(directory, key), std::ios::binary);
+	if (!file)
+		return false;
+
+	TRACE_ZONE("Load Program Binary");
+
+	uint32_t header[3] = {};
+	file.read((char*)header, sizeof(header));
+	if (!file || header[0] != programBinaryMagic || header[2] == 0)
+		return false;
+
+	std::vector<char> binary(header[2]);
+	file.read(binary.data(), binary.size());
+	if (!file)
+		return false;
+
+	*program = glCreateProgram();
+	glProgramBinary(*program, header[1], binary.data(), (GLsizei)binary.size());
+	int result = 0;
+	glGetProgramiv(*program, GL_LINK_STATUS, &result);
+	if (!result)
+	{
+		// driver update or corrupt file, rebuild from source and overwrite it
+		glDeleteProgram(*program);
+		*program = 0;
+		return false;
+	}
+	return true;
+}
+
+void SaveProgramBinary(const std::string& directory, uint64_t key, unsigned int program)
+{
+	if (directory.empty())
+		return;
+
+	TRACE_ZONE("Save Program Binary");
+
+	int length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, binary.data());
+
+	// write to a temporary name first so a crash never leaves a truncated binary behind
+	auto path = BinaryPath(directory, key);
+	auto tempPath = path + ".tmp";
+	bool written = false;
+	{
+		std::ofstream file(tempPath, std::ios::binary);
+		uint32_t header[3] = { programBinaryMagic, format, (uint32_t)length };
+		file.write((const char*)header, sizeof(header));
+		file.write(binary.data(), length);
+		file.close();
+		written = !file.fail();
+	}
+	std::error_code ec;
+	if (written)
+		std::filesystem::rename(tempPath, path, ec);
+	// nothing else ever looks at the temporary, a failed write or rename must not leave it behind
+	if (!written || ec)
+		std::filesystem::remove(tempPath, ec);
+}
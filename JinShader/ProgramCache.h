@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// Two tier cache of linked fragment programs, keyed by a hash of the assembled source and the
+// GL driver strings. Recently used programs stay alive in memory so going back to an earlier
+// version is instant, and program binaries are persisted to disk for cold starts.
+struct ProgramCacheEntry
+{
+	uint64_t key;
+	unsigned int program;
+	int pins;	// passes running the program, pinned entries are never evicted
+};
+
+struct JinShaderProgramCache
+{
+	int capacity = 32;
+	std::string directory;		// empty disables the disk tier
+	uint64_t driver_hash = 0;
+
+	std::list<ProgramCacheEntry> entries;	// most recently used first
+	std::unordered_map<uint64_t, std::list<ProgramCacheEntry>::iterator> lookup;
+};
+
+// Per-user directory for program binaries, %LOCALAPPDATA%\JinShader\shadercache on Windows and
+// $XDG_CACHE_HOME/jinshader or ~/.cache/jinshader elsewhere. Empty when none of those is known.
+std::string GetProgramCacheDirectory();
+
+// Needs a current context, the driver strings are part of every key
+void InitProgramCache(JinShaderProgramCache* cache, const char* directory, int capacity);
+void ShutdownProgramCache(JinShaderProgramCache* cache);
+
+uint64_t HashShaderSource(JinShaderProgramCache* cache, const std::string& code);
+
+// Memory tier, UI thread only. Returns 0 on a miss.
+unsigned int FindCachedProgram(JinShaderProgramCache* cache, uint64_t key);
+// Takes ownership of program, evicting (and deleting) the least recently used unpinned ones
+void AddCachedProgram(JinShaderProgramCache* cache, uint64_t key, unsigned int program);
+// Counted, every pin needs an unpin. Keys that are not cached are ignored.
+void PinCachedProgram(JinShaderProgramCache* cache, uint64_t key);
+void UnpinCachedProgram(JinShaderProgramCache* cache, uint64_t key);
+
+// Disk tier, only touches files and the calling thread's context
+bool LoadProgramBinary(const std::string& directory, uint64_t key, unsigned int* program);
+void SaveProgramBinary(const std::string& directory, uint64_t key, unsigned int program);
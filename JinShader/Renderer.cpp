@@ -0,0 +1,650 @@
+#include "Renderer.h"
+#include "Trace.h"
+#include <GL/glew.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+const char* commonShaderSource =
+	"#version 330 core\n"
+	"in vec4 fragCoord;\n"
+	"layout(std140) uniform ShaderToyInputs\n" // shared by all passes, see ShaderInputBlock
+	"{\n"
+	"\tvec3 iResolution;\n"                   // viewport resolution (in pixels)
+	"\tfloat iTime;\n"                        // shader playback time (in seconds)
+	"\tfloat iTimeDelta;\n"                   // render time (in seconds)
+	"\tint iFrame;\n"                         // shader playback frame
+	"\tfloat iSampleRate;\n"                  // sound sample rate (i.e., 44100)
+	"\tvec4 iMouse;\n"                        // mouse pixel coords. xy: current (if MLB down), zw: click
+	"\tvec4 iDate;\n"                         // (year, month, day, time in seconds)
+	"\tvec3 iChannelResolution[4];\n"         // channel resolution (in pixels)
+	"};\n"
+	//"uniform float iChannelTime[4];\n"      // channel playback time (in seconds)
+	"uniform sampler2D iChannel0;\n"         // input channels, buffers or images
+	"uniform sampler2D iChannel1;\n"
+	"uniform sampler2D iChannel2;\n"
+	"uniform sampler2D iChannel3;\n"
+	// the pass code follows as its own source string, numbered so driver logs match editor lines
+	"#line 1\n";
+
+const char* mainShaderSource =
+	"#version 330 core\n"
+	"out vec4 FinalColor;\n"
+	"void mainImage( out vec4 fragColor, in vec2 fragCoord );\n"
+	"void main()\n"
+	"{\n"
+	"\tmainImage(FinalColor, gl_FragCoord.xy);\n"
+	"}\n";
+
+const char* renderPassNames[RenderPass_Count] = { "Buffer A", "Buffer B", "Buffer C", "Buffer D", "Image" };
+const char* channelFilterNames[ChannelFilter_Count] = { "Mipmap", "Linear", "Nearest" };
+const char* channelWrapNames[ChannelWrap_Count] = { "Repeat", "Clamp" };
+
+const char* vertexShaderSource =
+	"#version 330 core\n"
+	"layout(location = 0) in vec4 in_position;\n"
+	"void main()\n"
+	"{\n"
+		"gl_Position = in_position;\n"
+	"}\n";
+
+static int PassTargetCount(int pass)
+{
+	return pass == RenderPass_Image ? 1 : 2;
+}
+
+static void ReleasePassTargets(RenderPass* pass)
+{
+	glDeleteTextures(2, pass->textures);
+	pass->textures[0] = pass->textures[1] = 0;
+}
+
+static void AllocatePassTargets(JinShaderRenderer* renderer, int index)
+{
+	RenderPass* pass = &renderer->passes[index];
+	ReleasePassTargets(pass);
+	pass->current = 0;
+	pass->dirty = true;
+	if (!pass->enabled || renderer->width <= 0 || renderer->height <= 0)
+		return;
+
+	// buffers hold simulation state, so they need the full float range
+	bool isBuffer = index != RenderPass_Image;
+	for (int i = 0; i < PassTargetCount(index); i++)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, pass->fbos[i]);
+		glGenTextures(1, &pass->textures[i]);
+		glBindTexture(GL_TEXTURE_2D, pass->textures[i]);
+		glTexImage2D(GL_TEXTURE_2D, 0, isBuffer ? GL_RGBA32F : GL_RGBA, renderer->width, renderer->height, 0, GL_RGBA, isBuffer ? GL_FLOAT : GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pass->textures[i], 0);
+		glClearColor(0, 0, 0, 0);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+static unsigned int CompileSharedShader(unsigned int type, const char* source, const char* name)
+{
+	unsigned int shader = glCreateShader(type);
+	glShaderSource(shader, 1, &source, 0);
+	glCompileShader(shader);
+	int result = 0;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
+
+	if (!result)
+	{
+		int len = 0;
+		glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
+		char* log = (char*)malloc(len);
+		glGetShaderInfoLog(shader, len, 0, log);
+		printf("%s Shader Compilation Failed! : %s\n", name, log);
+		free(log);
+	}
+	return shader;
+}
+
+void InitRenderer(JinShaderRenderer* renderer)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+		glGenFramebuffers(PassTargetCount(i), renderer->passes[i].fbos);
+	renderer->passes[RenderPass_Image].enabled = true;
+
+	renderer->stages.vertex = CompileSharedShader(GL_VERTEX_SHADER, vertexShaderSource, "Vertex");
+	renderer->stages.main = CompileSharedShader(GL_FRAGMENT_SHADER, mainShaderSource, "Main");
+
+	float quadVerts[4 * 4] =
+	{
+		-1,  1,  0, 1,
+		-1, -1,  0, 1,
+		 1, -1,  0, 1,
+		 1,  1,  0, 1
+	};
+	glGenBuffers(1, &renderer->vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 4 * 4, quadVerts, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 4, GL_FLOAT, 0, 0, 0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// one ShaderInputBlock per pass, each bound with glBindBufferRange
+	int alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	renderer->input_block_stride = ((int)sizeof(ShaderInputBlock) + alignment - 1) / alignment * alignment;
+	renderer->input_blocks.resize((size_t)renderer->input_block_stride * RenderPass_Count);
+	glGenBuffers(1, &renderer->ubo);
+}
+
+void ShutdownRenderer(JinShaderRenderer* renderer)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+	{
+		ReleasePassTargets(&renderer->passes[i]);
+		glDeleteFramebuffers(PassTargetCount(i), renderer->passes[i].fbos);
+	}
+	glDeleteSamplers((int)ChannelFilter_Count * ChannelWrap_Count, &renderer->samplers[0][0]);
+	glDeleteShader(renderer->stages.vertex);
+	glDeleteShader(renderer->stages.main);
+	glDeleteBuffers(1, &renderer->vbo);
+	glDeleteBuffers(1, &renderer->ubo);
+	*renderer = JinShaderRenderer();
+}
+
+void BuildShaderProgram(const ShaderStages& stages, const char* code, CompiledProgram* out)
+{
+	out->shader = glCreateShader(GL_FRAGMENT_SHADER);
+	// the status queries are where the driver actually waits for the work
+	uint64_t compileStart = GetTraceTime();
+	const char* sources[] = { commonShaderSource, code };
+	glShaderSource(out->shader, 2, sources, 0);
+	glCompileShader(out->shader);
+
+	int result = 0;
+	out->success = false;
+	out->compile_failed = false;
+	out->log.clear();
+	glGetShaderiv(out->shader, GL_COMPILE_STATUS, &result);
+	AddTraceEvent("Compile Shader", compileStart, GetTraceTime());
+	if (!result)
+	{
+		int len = 0;
+		glGetShaderiv(out->shader, GL_INFO_LOG_LENGTH, &len);
+		out->log.resize(len);
+		glGetShaderInfoLog(out->shader, len, 0, out->log.data());
+		out->compile_failed = true;
+		return;
+	}
+	LinkShaderProgram(stages, out);
+}
+
+void LinkShaderProgram(const ShaderStages& stages, CompiledProgram* out)
+{
+	int result = 0;
+	out->success = false;
+	out->log.clear();
+	out->program = glCreateProgram();
+	glAttachShader(out->program, stages.vertex);
+	glAttachShader(out->program, stages.main);
+	glAttachShader(out->program, out->shader);
+	if (GLEW_ARB_get_program_binary)
+		glProgramParameteri(out->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	uint64_t linkStart = GetTraceTime();
+	glLinkProgram(out->program);
+	glGetProgramiv(out->program, GL_LINK_STATUS, &result);
+	AddTraceEvent("Link Program", linkStart, GetTraceTime());
+	if (!result)
+	{
+		int len = 0;
+		glGetProgramiv(out->program, GL_INFO_LOG_LENGTH, &len);
+		out->log.resize(len);
+		glGetProgramInfoLog(out->program, len, 0, out->log.data());
+		return;
+	}
+
+	// the linked program keeps everything it needs, cached programs should not pin the shader objects
+	glDetachShader(out->program, stages.vertex);
+	glDetachShader(out->program, stages.main);
+	glDetachShader(out->program, out->shader);
+	glDeleteShader(out->shader);
+	out->shader = 0;
+	out->success = true;
+}
+
+bool ValidateShaderSource(const char* code, unsigned int* shader, std::string* log)
+{
+	TRACE_ZONE("Validate Shader");
+	*shader = glCreateShader(GL_FRAGMENT_SHADER);
+	const char* sources[] = { commonShaderSource, code };
+	glShaderSource(*shader, 2, sources, 0);
+	glCompileShader(*shader);
+
+	int result = 0;
+	int len = 0;
+	glGetShaderiv(*shader, GL_COMPILE_STATUS, &result);
+	glGetShaderiv(*shader, GL_INFO_LOG_LENGTH, &len);
+	log->resize(len);
+	if (len)
+		glGetShaderInfoLog(*shader, len, 0, log->data());
+	if (!result)
+	{
+		glDeleteShader(*shader);
+		*shader = 0;
+	}
+	return result != 0;
+}
+
+void DeleteCompiledProgram(CompiledProgram* compiled)
+{
+	if (compiled->shader)
+		glDeleteShader(compiled->shader);
+	if (compiled->program)
+		glDeleteProgram(compiled->program);
+	compiled->shader = 0;
+	compiled->program = 0;
+}
+
+unsigned int FindShaderInputs(const char* code)
+{
+	static const struct { const char* name; unsigned int flag; } inputs[] =
+	{
+		{ "iTime", ShaderInput_Time },
+		{ "iTimeDelta", ShaderInput_TimeDelta },
+		{ "iFrame", ShaderInput_Frame },
+		{ "iMouse", ShaderInput_Mouse },
+		{ "iDate", ShaderInput_Date },
+	};
+
+	unsigned int found = 0;
+	for (const char* c = code; *c;)
+	{
+		if (c[0] == '/' && c[1] == '/')
+		{
+			while (*c && *c != '\n')
+				c++;
+		}
+		else if (c[0] == '/' && c[1] == '*')
+		{
+			const char* end = strstr(c + 2, "*/");
+			c = end ? end + 2 : c + strlen(c);
+		}
+		else if (isalpha((unsigned char)*c) || *c == '_')
+		{
+			const char* start = c;
+			while (isalnum((unsigned char)*c) || *c == '_')
+				c++;
+			for (auto& input : inputs)
+				if ((size_t)(c - start) == strlen(input.name) && !strncmp(start, input.name, c - start))
+					found |= input.flag;
+		}
+		else
+		{
+			c++;
+		}
+	}
+	return found;
+}
+
+void SetPassProgram(JinShaderRenderer* renderer, int index, unsigned int program, unsigned int inputsUsed)
+{
+	RenderPass* pass = &renderer->passes[index];
+	pass->program = program;
+	pass->inputs_used = inputsUsed;
+	pass->dirty = true;
+	if (!program)
+		return;
+
+	unsigned int blockIndex = glGetUniformBlockIndex(program, "ShaderToyInputs");
+	if (blockIndex != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, blockIndex, 0);
+
+	// channel N always samples texture unit N
+	glUseProgram(program);
+	for (int c = 0; c < renderChannelCount; c++)
+	{
+		char name[16];
+		snprintf(name, sizeof(name), "iChannel%d", c);
+		pass->iChannelLocations[c] = glGetUniformLocation(program, name);
+		glUniform1i(pass->iChannelLocations[c], c);
+	}
+	glUseProgram(0);
+}
+
+void SetPassEnabled(JinShaderRenderer* renderer, int index, bool enabled)
+{
+	RenderPass* pass = &renderer->passes[index];
+	if (pass->enabled == enabled)
+		return;
+
+	pass->enabled = enabled;
+	if (enabled)
+		AllocatePassTargets(renderer, index);
+	else
+		ReleasePassTargets(pass);
+
+	// whoever reads this buffer now sees different data
+	for (auto& other : renderer->passes)
+		other.dirty = true;
+	renderer->order_dirty = true;
+}
+
+void SetPassChannel(JinShaderRenderer* renderer, int index, int channel, int input)
+{
+	RenderPass* pass = &renderer->passes[index];
+	if (pass->channels[channel] == input)
+		return;
+	pass->channels[channel] = input;
+	pass->channel_textures[channel] = 0;
+	pass->dirty = true;
+	renderer->order_dirty = true;
+}
+
+void SetPassChannelTexture(JinShaderRenderer* renderer, int index, int channel, ChannelTexture* texture)
+{
+	RenderPass* pass = &renderer->passes[index];
+	if (pass->channels[channel] != channelInputTexture)
+		renderer->order_dirty = true;
+	pass->channels[channel] = channelInputTexture;
+	pass->channel_textures[channel] = texture;
+	pass->dirty = true;
+}
+
+void SetPassChannelSampler(JinShaderRenderer* renderer, int index, int channel, int filter, int wrap)
+{
+	RenderPass* pass = &renderer->passes[index];
+	pass->channel_filters[channel] = filter;
+	pass->channel_wraps[channel] = wrap;
+	pass->dirty = true;
+}
+
+static unsigned int GetChannelSampler(JinShaderRenderer* renderer, int filter, int wrap)
+{
+	unsigned int& sampler = renderer->samplers[filter][wrap];
+	if (sampler)
+		return sampler;
+
+	static const GLenum minFilters[ChannelFilter_Count] = { GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_NEAREST };
+	GLenum wrapMode = wrap == ChannelWrap_Repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+	glGenSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilters[filter]);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, filter == ChannelFilter_Nearest ? GL_NEAREST : GL_LINEAR);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrapMode);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrapMode);
+	return sampler;
+}
+
+// What a channel reads right now, false when it reads nothing (black)
+struct ChannelSource
+{
+	unsigned int texture;
+	int width, height;
+	uint64_t version;
+	ChannelTexture* image;
+};
+
+static bool GetChannelSource(JinShaderRenderer* renderer, int index, int channel, ChannelSource* source)
+{
+	RenderPass* pass = &renderer->passes[index];
+	int input = pass->channels[channel];
+	if (input == channelInputTexture)
+	{
+		ChannelTexture* image = pass->channel_textures[channel];
+		if (!image || !image->texture)
+			return false;
+		*source = { image->texture, image->width, image->height, image->version, image };
+		return true;
+	}
+	if (input == channelInputNone || !renderer->passes[input].enabled)
+		return false;
+
+	RenderPass* buffer = &renderer->passes[input];
+	*source = { buffer->textures[buffer->current], renderer->width, renderer->height, buffer->output_version, 0 };
+	return true;
+}
+
+static bool ReadsChannelInput(RenderPass* passes, int input, int self)
+{
+	return input >= 0 && input != self && passes[input].enabled;
+}
+
+// Buffers run after the buffers they read from. Passes caught in a cycle read the other pass'
+// previous frame, just like ShaderToy does for its fixed A, B, C, D, Image order.
+static void UpdatePassOrder(JinShaderRenderer* renderer)
+{
+	bool placed[RenderPass_Count] = {};
+	renderer->order_count = 0;
+	while (true)
+	{
+		int next = -1;
+		for (int i = 0; i < renderBufferCount && next == -1; i++)
+		{
+			RenderPass* pass = &renderer->passes[i];
+			if (!pass->enabled || placed[i])
+				continue;
+			bool ready = true;
+			for (int c = 0; c < renderChannelCount; c++)
+				if (ReadsChannelInput(renderer->passes, pass->channels[c], i) && !placed[pass->channels[c]])
+					ready = false;
+			if (ready)
+				next = i;
+		}
+
+		for (int i = 0; i < renderBufferCount && next == -1; i++)
+			if (renderer->passes[i].enabled && !placed[i])
+				next = i;
+
+		if (next == -1)
+			break;
+		placed[next] = true;
+		renderer->order[renderer->order_count++] = next;
+	}
+	renderer->order[renderer->order_count++] = RenderPass_Image;
+	renderer->order_dirty = false;
+}
+
+void ResizeRenderTarget(JinShaderRenderer* renderer, int width, int height)
+{
+	renderer->width = width;
+	renderer->height = height;
+	for (int i = 0; i < RenderPass_Count; i++)
+		AllocatePassTargets(renderer, i);
+}
+
+static uint64_t HashInput(uint64_t hash, const void* data, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= ((const unsigned char*)data)[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+// Fingerprint of everything that can change what a pass draws. Inputs the code never mentions
+// are left out, so a static shader hashes the same every frame.
+static uint64_t HashPassInputs(JinShaderRenderer* renderer, int index, const ShaderInputs& inputs)
+{
+	RenderPass* pass = &renderer->passes[index];
+	bool feedback = false;
+	uint64_t hash = 0xcbf29ce484222325ull;
+	hash = HashInput(hash, &pass->program, sizeof(pass->program));
+	hash = HashInput(hash, &renderer->width, sizeof(renderer->width));
+	hash = HashInput(hash, &renderer->height, sizeof(renderer->height));
+	for (int c = 0; c < renderChannelCount; c++)
+	{
+		// reading its own output never settles, feedback loops step with time instead
+		if (pass->channels[c] == index)
+		{
+			feedback = true;
+			continue;
+		}
+		ChannelSource source = {};
+		GetChannelSource(renderer, index, c, &source);
+		hash = HashInput(hash, &source.texture, sizeof(source.texture));
+		hash = HashInput(hash, &source.version, sizeof(source.version));
+		hash = HashInput(hash, &pass->channel_filters[c], sizeof(pass->channel_filters[c]));
+		hash = HashInput(hash, &pass->channel_wraps[c], sizeof(pass->channel_wraps[c]));
+	}
+
+	unsigned int used = pass->inputs_used;
+	if ((used & ShaderInput_Time) || feedback)
+		hash = HashInput(hash, &inputs.time, sizeof(inputs.time));
+	if (used & ShaderInput_TimeDelta)
+		hash = HashInput(hash, &inputs.time_delta, sizeof(inputs.time_delta));
+	if ((used & ShaderInput_Frame) || feedback)
+		hash = HashInput(hash, &inputs.frame, sizeof(inputs.frame));
+	if (used & ShaderInput_Mouse)
+		hash = HashInput(hash, inputs.mouse, sizeof(inputs.mouse));
+	if (used & ShaderInput_Date)
+		hash = HashInput(hash, inputs.date, sizeof(inputs.date));
+	return hash;
+}
+
+static void FillInputBlock(JinShaderRenderer* renderer, int index, const ShaderInputs& inputs, ShaderInputBlock* block)
+{
+	*block = ShaderInputBlock();
+	block->resolution[0] = (float)renderer->width;
+	block->resolution[1] = (float)renderer->height;
+	block->time = inputs.time;
+	block->time_delta = inputs.time_delta;
+	block->frame = inputs.frame;
+	block->sample_rate = inputs.sample_rate;
+	memcpy(block->mouse, inputs.mouse, sizeof(block->mouse));
+	memcpy(block->date, inputs.date, sizeof(block->date));
+	for (int c = 0; c < renderChannelCount; c++)
+	{
+		ChannelSource source = {};
+		if (!GetChannelSource(renderer, index, c, &source))
+			continue;
+		block->channel_resolution[c][0] = (float)source.width;
+		block->channel_resolution[c][1] = (float)source.height;
+		block->channel_resolution[c][2] = 1.0f;
+	}
+}
+
+// One upload for every pass, orphaning the previous frame's storage so it never waits on the GPU
+static void UploadInputBlocks(JinShaderRenderer* renderer, const ShaderInputs& inputs)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+		if (renderer->passes[i].enabled && renderer->passes[i].program)
+			FillInputBlock(renderer, i, inputs, (ShaderInputBlock*)&renderer->input_blocks[(size_t)i * renderer->input_block_stride]);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, renderer->ubo);
+	glBufferData(GL_UNIFORM_BUFFER, renderer->input_blocks.size(), renderer->input_blocks.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+bool RenderShader(JinShaderRenderer* renderer, const ShaderInputs& inputs)
+{
+	if (renderer->order_dirty)
+		UpdatePassOrder(renderer);
+
+	bool imageChanged = false;
+	bool stateBound = false;
+	for (int o = 0; o < renderer->order_count; o++)
+	{
+		int index = renderer->order[o];
+		RenderPass* pass = &renderer->passes[index];
+		if (!pass->program || !pass->textures[0])
+			continue;
+
+		uint64_t inputHash = HashPassInputs(renderer, index, inputs);
+		if (!pass->dirty && inputHash == pass->input_hash)
+			continue;
+
+		TRACE_ZONE(renderPassNames[index]);
+
+		if (!stateBound)
+		{
+			glViewport(0, 0, renderer->width, renderer->height);
+			glBindBuffer(GL_ARRAY_BUFFER, renderer->vbo);
+			glVertexAttribPointer(0, 4, GL_FLOAT, 0, 0, 0);
+			glEnableVertexAttribArray(0);
+			UploadInputBlocks(renderer, inputs);
+			stateBound = true;
+		}
+
+		// a buffer reading itself sees its previous frame, the one at current
+		for (int c = 0; c < renderChannelCount; c++)
+		{
+			ChannelSource source = {};
+			bool hasSource = GetChannelSource(renderer, index, c, &source);
+
+			// buffers have no mip chain, they fall back to plain linear filtering
+			int filter = pass->channel_filters[c];
+			if (filter == ChannelFilter_Mipmap && !source.image)
+				filter = ChannelFilter_Linear;
+
+			glActiveTexture(GL_TEXTURE0 + c);
+			glBindTexture(GL_TEXTURE_2D, source.texture);
+			if (filter == ChannelFilter_Mipmap && !source.image->has_mips)
+			{
+				glGenerateMipmap(GL_TEXTURE_2D);
+				source.image->has_mips = true;
+			}
+			glBindSampler(c, hasSource ? GetChannelSampler(renderer, filter, pass->channel_wraps[c]) : 0);
+		}
+
+		int target = index == RenderPass_Image ? 0 : 1 - pass->current;
+		glBindFramebuffer(GL_FRAMEBUFFER, pass->fbos[target]);
+
+		glBindBufferRange(GL_UNIFORM_BUFFER, 0, renderer->ubo, (GLintptr)index * renderer->input_block_stride, sizeof(ShaderInputBlock));
+		glUseProgram(pass->program);
+		glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+
+		// swapping the handles is all the feedback copy there is
+		pass->current = target;
+		pass->output_version++;
+		pass->input_hash = inputHash;
+		pass->dirty = false;
+		if (index == RenderPass_Image)
+			imageChanged = true;
+	}
+
+	if (!stateBound)
+		return false;
+
+	for (int c = 0; c < renderChannelCount; c++)
+	{
+		glActiveTexture(GL_TEXTURE0 + c);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindSampler(c, 0);
+	}
+	glActiveTexture(GL_TEXTURE0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, 0, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	return imageChanged;
+}
+
+bool IsRendererAnimating(JinShaderRenderer* renderer)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+	{
+		RenderPass* pass = &renderer->passes[i];
+		if (!pass->enabled || !pass->program)
+			continue;
+		if (pass->inputs_used & (ShaderInput_Time | ShaderInput_TimeDelta | ShaderInput_Frame | ShaderInput_Date))
+			return true;
+		for (int c = 0; c < renderChannelCount; c++)
+			if (pass->channels[c] == i)
+				return true;
+	}
+	return false;
+}
+
+unsigned int GetOutputTexture(JinShaderRenderer* renderer)
+{
+	return renderer->passes[RenderPass_Image].textures[0];
+}
+
+void ReadRenderTarget(JinShaderRenderer* renderer, unsigned char* pixels)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, renderer->passes[RenderPass_Image].fbos[0]);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, renderer->width, renderer->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
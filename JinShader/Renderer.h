@@ -0,0 +1,199 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// Per-frame ShaderToy inputs fed to the fragment program
+struct ShaderInputs
+{
+	float time = 0.0f;
+	float time_delta = 0.0f;
+	int frame = 0;
+	float mouse[4] = {};
+	float date[4] = {};		// year, month (0-11), day, seconds since midnight
+	float sample_rate = 44100.0f;
+};
+
+// std140 mirror of the ShaderToyInputs block in commonShaderSource
+struct ShaderInputBlock
+{
+	float resolution[3] = {};
+	float time = 0.0f;
+	float time_delta = 0.0f;
+	int frame = 0;
+	float sample_rate = 0.0f;
+	float padding = 0.0f;
+	float mouse[4] = {};
+	float date[4] = {};
+	float channel_resolution[4][4] = {};	// vec3 array elements are padded to 16 bytes
+};
+
+// Inputs a shader reads, everything else is left out of its change detection
+enum ShaderInputFlags
+{
+	ShaderInput_Time = 1 << 0,
+	ShaderInput_TimeDelta = 1 << 1,
+	ShaderInput_Frame = 1 << 2,
+	ShaderInput_Mouse = 1 << 3,
+	ShaderInput_Date = 1 << 4,
+};
+
+// ShaderToy style passes. Buffers render into float textures the other passes can read through
+// their iChannels, Image is what ends up on screen.
+enum RenderPassId
+{
+	RenderPass_BufferA,
+	RenderPass_BufferB,
+	RenderPass_BufferC,
+	RenderPass_BufferD,
+	RenderPass_Image,
+	RenderPass_Count
+};
+
+const int renderBufferCount = RenderPass_Image;
+const int renderChannelCount = 4;
+const int channelInputNone = -1;	// otherwise a channel holds the RenderPassId of a buffer
+const int channelInputTexture = -2;	// an image file, see TextureLoader
+
+extern const char* renderPassNames[RenderPass_Count];
+
+// Sampler settings per channel, ShaderToy defaults to mipmap + repeat for images
+enum ChannelFilter
+{
+	ChannelFilter_Mipmap,
+	ChannelFilter_Linear,
+	ChannelFilter_Nearest,
+	ChannelFilter_Count
+};
+
+enum ChannelWrap
+{
+	ChannelWrap_Repeat,
+	ChannelWrap_Clamp,
+	ChannelWrap_Count
+};
+
+extern const char* channelFilterNames[ChannelFilter_Count];
+extern const char* channelWrapNames[ChannelWrap_Count];
+
+// An image on the GPU, texture stays 0 until the TextureLoader finished uploading it
+struct ChannelTexture
+{
+	unsigned int texture = 0;
+	int width = 0, height = 0;
+	bool has_mips = false;	// built the first time a channel samples it with ChannelFilter_Mipmap
+	uint64_t version = 0;	// bumped whenever texture changes
+};
+
+struct RenderPass
+{
+	bool enabled = false;
+	unsigned int program = 0;	// not owned, see SetPassProgram
+	int channels[renderChannelCount] = { channelInputNone, channelInputNone, channelInputNone, channelInputNone };
+	ChannelTexture* channel_textures[renderChannelCount] = {};	// not owned, for channelInputTexture
+	int channel_filters[renderChannelCount] = { ChannelFilter_Linear, ChannelFilter_Linear, ChannelFilter_Linear, ChannelFilter_Linear };
+	int channel_wraps[renderChannelCount] = { ChannelWrap_Clamp, ChannelWrap_Clamp, ChannelWrap_Clamp, ChannelWrap_Clamp };
+
+	// buffers ping-pong between two targets, the one at `current` holds the latest output.
+	// Image only uses the first one.
+	unsigned int fbos[2] = {};
+	unsigned int textures[2] = {};
+	int current = 0;
+
+	unsigned int inputs_used = 0;	// ShaderInputFlags
+	int iChannelLocations[renderChannelCount] = { -1, -1, -1, -1 };
+
+	// a pass is skipped while the hash of everything it reads matches the one it last ran with
+	bool dirty = true;
+	uint64_t input_hash = 0;
+	uint64_t output_version = 0;
+};
+
+// Shader objects compiled once by InitRenderer and linked into every pass program, so a build
+// only compiles the pass code and the declarations in commonShaderSource
+struct ShaderStages
+{
+	unsigned int vertex = 0;
+	unsigned int main = 0;	// the fragment main() calling mainImage, see mainShaderSource
+};
+
+// Everything needed to run ShaderToy style fragment programs into offscreen textures.
+// Shared by the editor and the headless renderer so both go through the same path.
+struct JinShaderRenderer
+{
+	ShaderStages stages;
+	unsigned int vbo = 0;
+	unsigned int ubo = 0;
+	int width = 0, height = 0;
+
+	// staging copy of the uniform buffer, one ShaderInputBlock per pass at input_block_stride
+	std::vector<unsigned char> input_blocks;
+	int input_block_stride = 0;
+
+	RenderPass passes[RenderPass_Count];
+	unsigned int samplers[ChannelFilter_Count][ChannelWrap_Count] = {};	// created on first use
+	int order[RenderPass_Count] = {};
+	int order_count = 0;
+	bool order_dirty = true;
+};
+
+// Result of building a fragment program. The objects are owned by whoever receives it.
+// On success the fragment shader object is already released and only the program is left.
+struct CompiledProgram
+{
+	unsigned int program = 0, shader = 0;
+	uint64_t key = 0;			// ProgramCache key of the source
+	int pass = RenderPass_Image;
+	unsigned int inputs_used = 0;	// FindShaderInputs of the source
+	float build_ms = 0.0f;			// compile + link, or loading the binary
+	bool success = false;
+	bool compile_failed = false;
+	bool from_disk_cache = false;
+	std::string log;
+};
+
+extern const char* commonShaderSource;
+extern const char* mainShaderSource;
+extern const char* vertexShaderSource;
+
+void InitRenderer(JinShaderRenderer* renderer);
+void ShutdownRenderer(JinShaderRenderer* renderer);
+
+// Compiles code as a second source string after commonShaderSource, without copying either, and
+// links it with stages. Touches no renderer state, so it can run on any thread whose context
+// shares objects with the renderer's context.
+void BuildShaderProgram(const ShaderStages& stages, const char* code, CompiledProgram* out);
+// The second half of BuildShaderProgram: links the already compiled out->shader with stages
+void LinkShaderProgram(const ShaderStages& stages, CompiledProgram* out);
+// Compiles code like BuildShaderProgram without linking, the info log goes to *log. On success the
+// shader object is kept in *shader so a save can go straight to LinkShaderProgram.
+bool ValidateShaderSource(const char* code, unsigned int* shader, std::string* log);
+void DeleteCompiledProgram(CompiledProgram* compiled);
+
+// ShaderInputFlags of the inputs code mentions outside of comments. Members of a std140 block
+// always count as active, so GL reflection cannot tell us this.
+unsigned int FindShaderInputs(const char* code);
+
+// Makes a linked program current for a pass. The renderer only borrows it, the caller (normally
+// the ProgramCache) keeps ownership and must keep it alive while it is in use.
+void SetPassProgram(JinShaderRenderer* renderer, int pass, unsigned int program, unsigned int inputsUsed);
+void SetPassEnabled(JinShaderRenderer* renderer, int pass, bool enabled);
+void SetPassChannel(JinShaderRenderer* renderer, int pass, int channel, int input);
+// The texture is borrowed and may still be loading, the channel reads black until it is ready
+void SetPassChannelTexture(JinShaderRenderer* renderer, int pass, int channel, ChannelTexture* texture);
+void SetPassChannelSampler(JinShaderRenderer* renderer, int pass, int channel, int filter, int wrap);
+
+// Reallocates every pass target, buffers start out cleared to zero
+void ResizeRenderTarget(JinShaderRenderer* renderer, int width, int height);
+
+// Runs the enabled passes in dependency order, skipping the ones whose output cannot have
+// changed. Returns true when the Image output changed.
+bool RenderShader(JinShaderRenderer* renderer, const ShaderInputs& inputs);
+
+// True when an enabled pass changes with time (iTime, iTimeDelta, iFrame or a feedback loop)
+bool IsRendererAnimating(JinShaderRenderer* renderer);
+
+unsigned int GetOutputTexture(JinShaderRenderer* renderer);
+
+// Reads back the Image output as tightly packed RGBA8, bottom row first
+void ReadRenderTarget(JinShaderRenderer* renderer, unsigned char* pixels);
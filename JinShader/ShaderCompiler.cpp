@@ -0,0 +1,316 @@
+#include "ShaderCompiler.h"
+#include "ProgramCache.h"
+#include "Trace.h"
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+// validatedShader is the compiled code when validation got to it first, 0 otherwise. It is used up either way.
+static void BuildOrLoadProgram(JinShaderCompiler* compiler, const std::string& code, uint64_t key, unsigned int validatedShader, CompiledProgram* out)
+{
+	TRACE_ZONE("Build Program");
+	auto start = std::chrono::steady_clock::now();
+	out->key = key;
+	out->inputs_used = FindShaderInputs(code.c_str());
+	if (LoadProgramBinary(compiler->cache_directory, key, &out->program))
+	{
+		out->success = true;
+		out->from_disk_cache = true;
+		if (validatedShader)
+			glDeleteShader(validatedShader);
+	}
+	else
+	{
+		if (validatedShader)
+		{
+			out->shader = validatedShader;
+			LinkShaderProgram(compiler->stages, out);
+		}
+		else
+		{
+			BuildShaderProgram(compiler->stages, code.c_str(), out);
+		}
+		if (out->success)
+			SaveProgramBinary(compiler->cache_directory, key, out->program);
+	}
+	out->build_ms = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Returns the pass of the first pending request in requests, -1 if there is none
+static int TakeRequest(ShaderCompileRequest* requests, std::string* code, uint64_t* key, uint64_t* generation)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+	{
+		ShaderCompileRequest& request = requests[i];
+		if (!request.pending)
+			continue;
+		// swapped so both strings keep their capacity for the next save
+		code->swap(request.code);
+		*generation = request.generation;
+		*key = request.key;
+		request.pending = false;
+		return i;
+	}
+	return -1;
+}
+
+static bool HasPendingRequest(const ShaderCompileRequest* requests)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+		if (requests[i].pending)
+			return true;
+	return false;
+}
+
+static void PutRequest(ShaderCompileRequest* request, const std::string& code, uint64_t key)
+{
+	request->code = code;
+	request->key = key;
+	request->pending = true;
+	request->generation++;
+}
+
+static void DropResult(JinShaderCompiler* compiler, int pass)
+{
+	for (size_t i = 0; i < compiler->results.size(); i++)
+	{
+		if (compiler->results[i].pass != pass)
+			continue;
+		DeleteCompiledProgram(&compiler->results[i]);
+		compiler->results.erase(compiler->results.begin() + i);
+		return;
+	}
+}
+
+static void DropValidation(JinShaderCompiler* compiler, int pass)
+{
+	for (size_t i = 0; i < compiler->validations.size(); i++)
+	{
+		if (compiler->validations[i].pass != pass)
+			continue;
+		compiler->validations.erase(compiler->validations.begin() + i);
+		return;
+	}
+}
+
+// Hands over the shader a validation left for key, if any. Called with the mutex held.
+static unsigned int TakeValidatedShader(JinShaderCompiler* compiler, uint64_t key)
+{
+	for (int i = 0; i < RenderPass_Count; i++)
+	{
+		ValidatedShader& validated = compiler->validated[i];
+		if (!validated.shader || validated.key != key)
+			continue;
+		unsigned int shader = validated.shader;
+		validated.shader = 0;
+		return shader;
+	}
+	return 0;
+}
+
+static void ValidateWorker(JinShaderCompiler* compiler)
+{
+	glfwMakeContextCurrent(compiler->validate_context);
+	SetTraceThreadName("Shader Validator");
+
+	std::unique_lock<std::mutex> lock(compiler->mutex);
+	while (true)
+	{
+		compiler->validate_wake.wait(lock, [compiler]
+		{
+			return HasPendingRequest(compiler->validation_requests) || compiler->quit;
+		});
+		if (compiler->quit)
+			break;
+
+		ShaderValidation validation;
+		uint64_t generation = 0;
+		unsigned int shader = 0;
+		validation.pass = TakeRequest(compiler->validation_requests, &compiler->validate_code, &validation.key, &generation);
+		lock.unlock();
+
+		validation.success = ValidateShaderSource(compiler->validate_code.c_str(), &shader, &validation.log);
+		// the build context may only link the shader once it is complete
+		if (shader)
+			glFinish();
+
+		lock.lock();
+		if (compiler->validation_requests[validation.pass].generation != generation)
+		{
+			if (shader)
+				glDeleteShader(shader);
+			continue;
+		}
+
+		ValidatedShader& validated = compiler->validated[validation.pass];
+		if (validated.shader)
+			glDeleteShader(validated.shader);
+		validated.key = validation.key;
+		validated.shader = shader;
+		DropValidation(compiler, validation.pass);
+		compiler->validations.push_back(std::move(validation));
+		glfwPostEmptyEvent();
+	}
+	lock.unlock();
+
+	glfwMakeContextCurrent(0);
+}
+
+static void CompileWorker(JinShaderCompiler* compiler)
+{
+	glfwMakeContextCurrent(compiler->context);
+	SetTraceThreadName("Shader Compiler");
+
+	std::unique_lock<std::mutex> lock(compiler->mutex);
+	while (true)
+	{
+		compiler->wake.wait(lock, [compiler]
+		{
+			return HasPendingRequest(compiler->requests) || compiler->quit;
+		});
+		if (compiler->quit)
+			break;
+
+		CompiledProgram compiled;
+		uint64_t generation = 0;
+		compiled.pass = TakeRequest(compiler->requests, &compiler->build_code, &compiled.key, &generation);
+		unsigned int validatedShader = TakeValidatedShader(compiler, compiled.key);
+		compiler->busy = true;
+		lock.unlock();
+
+		BuildOrLoadProgram(compiler, compiler->build_code, compiled.key, validatedShader, &compiled);
+		// the UI context may only use the new objects once they are complete
+		{
+			TRACE_ZONE("glFinish");
+			glFinish();
+		}
+
+		lock.lock();
+		compiler->busy = false;
+
+		// a newer save came in while we were compiling, this result is already stale
+		if (compiler->requests[compiled.pass].generation != generation)
+		{
+			DeleteCompiledProgram(&compiled);
+			continue;
+		}
+
+		DropResult(compiler, compiled.pass);
+		compiler->results.push_back(std::move(compiled));
+		glfwPostEmptyEvent();
+	}
+	lock.unlock();
+
+	glfwMakeContextCurrent(0);
+}
+
+void InitShaderCompiler(JinShaderCompiler* compiler, GLFWwindow* sharedContext, GLFWwindow* validateContext, const ShaderStages& stages, const std::string& cacheDirectory)
+{
+	compiler->context = sharedContext;
+	compiler->validate_context = validateContext;
+	compiler->stages = stages;
+	compiler->cache_directory = cacheDirectory;
+	if (compiler->context)
+		compiler->worker = std::thread(CompileWorker, compiler);
+	if (compiler->validate_context)
+		compiler->validate_worker = std::thread(ValidateWorker, compiler);
+}
+
+void ShutdownShaderCompiler(JinShaderCompiler* compiler)
+{
+	{
+		std::lock_guard<std::mutex> lock(compiler->mutex);
+		compiler->quit = true;
+	}
+	compiler->wake.notify_one();
+	compiler->validate_wake.notify_one();
+	if (compiler->worker.joinable())
+		compiler->worker.join();
+	if (compiler->validate_worker.joinable())
+		compiler->validate_worker.join();
+
+	for (auto& result : compiler->results)
+		DeleteCompiledProgram(&result);
+	compiler->results.clear();
+	for (auto& validated : compiler->validated)
+	{
+		if (validated.shader)
+			glDeleteShader(validated.shader);
+		validated = ValidatedShader();
+	}
+
+	if (compiler->context)
+		glfwDestroyWindow(compiler->context);
+	if (compiler->validate_context)
+		glfwDestroyWindow(compiler->validate_context);
+	compiler->context = 0;
+	compiler->validate_context = 0;
+}
+
+void RequestShaderCompile(JinShaderCompiler* compiler, int pass, const std::string& code, uint64_t key)
+{
+	{
+		std::lock_guard<std::mutex> lock(compiler->mutex);
+		PutRequest(&compiler->requests[pass], code, key);
+	}
+	compiler->wake.notify_one();
+}
+
+void RequestShaderValidation(JinShaderCompiler* compiler, int pass, const std::string& code, uint64_t key)
+{
+	if (!compiler->validate_context)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(compiler->mutex);
+		PutRequest(&compiler->validation_requests[pass], code, key);
+	}
+	compiler->validate_wake.notify_one();
+}
+
+void CancelShaderCompile(JinShaderCompiler* compiler, int pass)
+{
+	std::lock_guard<std::mutex> lock(compiler->mutex);
+	ShaderCompileRequest& request = compiler->requests[pass];
+	request.pending = false;
+	request.generation++;
+	DropResult(compiler, pass);
+}
+
+bool IsShaderCompileRunning(JinShaderCompiler* compiler)
+{
+	std::lock_guard<std::mutex> lock(compiler->mutex);
+	return compiler->busy || HasPendingRequest(compiler->requests);
+}
+
+bool PollShaderCompile(JinShaderCompiler* compiler, CompiledProgram* result)
+{
+	std::lock_guard<std::mutex> lock(compiler->mutex);
+
+	if (!compiler->context)
+	{
+		uint64_t generation = 0;
+		result->pass = TakeRequest(compiler->requests, &compiler->build_code, &result->key, &generation);
+		if (result->pass < 0)
+			return false;
+		BuildOrLoadProgram(compiler, compiler->build_code, result->key, TakeValidatedShader(compiler, result->key), result);
+		return true;
+	}
+
+	if (compiler->results.empty())
+		return false;
+
+	*result = std::move(compiler->results.front());
+	compiler->results.erase(compiler->results.begin());
+	return true;
+}
+
+bool PollShaderValidation(JinShaderCompiler* compiler, ShaderValidation* result)
+{
+	std::lock_guard<std::mutex> lock(compiler->mutex);
+	if (compiler->validations.empty())
+		return false;
+
+	*result = std::move(compiler->validations.front());
+	compiler->validations.erase(compiler->validations.begin());
+	return true;
+}
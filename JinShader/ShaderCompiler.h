@@ -0,0 +1,82 @@
+#pragma once
+#include "Renderer.h"
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct GLFWwindow;
+
+// Compiles and links fragment programs on a worker thread with its own shared GL context, so a
+// heavy shader never blocks the UI. Only the newest request matters: saving again while a
+// compile is running replaces whatever was still waiting, and results that were overtaken by a
+// newer request are thrown away instead of being shown. Each render pass has its own slot.
+struct ShaderCompileRequest
+{
+	std::string code;
+	uint64_t key = 0;
+	uint64_t generation = 0;	// bumped by every request/cancel, older builds are stale
+	bool pending = false;
+};
+
+// Outcome of compiling a pass' source without linking it, to report errors while typing
+struct ShaderValidation
+{
+	int pass = RenderPass_Image;
+	uint64_t key = 0;
+	bool success = false;
+	std::string log;
+};
+
+// Fragment shader that passed validation, kept so saving the same source only has to link it
+struct ValidatedShader
+{
+	uint64_t key = 0;
+	unsigned int shader = 0;
+};
+
+struct JinShaderCompiler
+{
+	GLFWwindow* context = 0;
+	GLFWwindow* validate_context = 0;
+	ShaderStages stages;
+	std::string cache_directory;	// program binaries are looked up and stored here
+	std::thread worker;
+	std::thread validate_worker;	// separate from builds, so a check while typing never holds up a save
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable validate_wake;
+	std::string build_code;	// only touched by whoever builds, never shrinks so saves stop allocating
+	std::string validate_code;	// the same for the validation worker
+
+	// guarded by mutex
+	ShaderCompileRequest requests[RenderPass_Count];
+	bool busy = false;
+	bool quit = false;
+	std::vector<CompiledProgram> results;	// at most one per pass
+	ShaderCompileRequest validation_requests[RenderPass_Count];
+	std::vector<ShaderValidation> validations;	// at most one per pass
+	ValidatedShader validated[RenderPass_Count];	// newest successful validation of each pass
+};
+
+// Falls back to compiling synchronously inside PollShaderCompile when no shared context is given.
+// Validation needs a context of its own and is skipped without one, the UI thread never compiles
+// while the user is typing.
+void InitShaderCompiler(JinShaderCompiler* compiler, GLFWwindow* sharedContext, GLFWwindow* validateContext, const ShaderStages& stages, const std::string& cacheDirectory);
+void ShutdownShaderCompiler(JinShaderCompiler* compiler);
+
+// key is the ProgramCache key of code, used to find and store the program binary on disk
+void RequestShaderCompile(JinShaderCompiler* compiler, int pass, const std::string& code, uint64_t key);
+// Drops the pass' waiting request and makes any build in flight stale, e.g. after a cache hit
+void CancelShaderCompile(JinShaderCompiler* compiler, int pass);
+bool IsShaderCompileRunning(JinShaderCompiler* compiler);
+
+// Returns true when a build finished, one at a time, result->pass tells which. The caller owns the objects in *result:
+// hand the program to AddCachedProgram on success or call DeleteCompiledProgram on failure.
+bool PollShaderCompile(JinShaderCompiler* compiler, CompiledProgram* result);
+
+// Compile only, same newest-request-wins rules as builds. key is passed through to the result,
+// and a build of the same key links the validated shader instead of compiling again.
+void RequestShaderValidation(JinShaderCompiler* compiler, int pass, const std::string& code, uint64_t key);
+bool PollShaderValidation(JinShaderCompiler* compiler, ShaderValidation* result);
@@ -0,0 +1,212 @@
+#include "ShaderLog.h"
+#include <string.h>
+#include <chrono>
+#include <map>
+#include <regex>
+
+static bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static bool IsBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static bool SkipText(const char*& p, const char* end, const char* text)
+{
+	size_t len = strlen(text);
+	if ((size_t)(end - p) < len || memcmp(p, text, len) != 0)
+		return false;
+	p += len;
+	return true;
+}
+
+static bool SkipChar(const char*& p, const char* end, char c)
+{
+	if (p == end || *p != c)
+		return false;
+	p++;
+	return true;
+}
+
+static void SkipBlanks(const char*& p, const char* end)
+{
+	while (p < end && IsBlank(*p))
+		p++;
+}
+
+static bool ParseInt(const char*& p, const char* end, int* value)
+{
+	if (p == end || !IsDigit(*p))
+		return false;
+	int v = 0;
+	while (p < end && IsDigit(*p))
+		v = v * 10 + (*p++ - '0');
+	*value = v;
+	return true;
+}
+
+// "error" or "warning", also taking NVIDIA's "error C1008:" and "fatal error"
+static bool ParseSeverityWord(const char*& p, const char* end, ShaderLogSeverity* severity)
+{
+	SkipText(p, end, "fatal ");
+	if (SkipText(p, end, "error"))
+		*severity = ShaderLogSeverity_Error;
+	else if (SkipText(p, end, "warning"))
+		*severity = ShaderLogSeverity_Warning;
+	else
+		return false;
+	SkipChar(p, end, ':');
+	SkipBlanks(p, end);
+	return true;
+}
+
+// ERROR: 0:12: 'x' : undeclared identifier
+static bool ParseUpperCaseLine(const char* p, const char* end, ShaderDiagnostic* out)
+{
+	if (SkipText(p, end, "ERROR:"))
+		out->severity = ShaderLogSeverity_Error;
+	else if (SkipText(p, end, "WARNING:"))
+		out->severity = ShaderLogSeverity_Warning;
+	else
+		return false;
+
+	SkipBlanks(p, end);
+	if (!ParseInt(p, end, &out->file) || !SkipChar(p, end, ':'))
+		return false;
+	// ANGLE writes "0:?:" when it has no line
+	if (!ParseInt(p, end, &out->line) && !SkipChar(p, end, '?'))
+		return false;
+	if (!SkipChar(p, end, ':'))
+		return false;
+	SkipBlanks(p, end);
+	out->message.assign(p, end);
+	return true;
+}
+
+// Mesa 0:12(5): error: message, NVIDIA 0(12) : error C1008: message
+static bool ParseNumberedLine(const char* p, const char* end, ShaderDiagnostic* out)
+{
+	if (!ParseInt(p, end, &out->file))
+		return false;
+
+	if (SkipChar(p, end, ':'))
+	{
+		if (!ParseInt(p, end, &out->line))
+			return false;
+		if (SkipChar(p, end, '(') && (!ParseInt(p, end, &out->column) || !SkipChar(p, end, ')')))
+			return false;
+	}
+	else if (SkipChar(p, end, '('))
+	{
+		if (!ParseInt(p, end, &out->line) || !SkipChar(p, end, ')'))
+			return false;
+	}
+	else
+	{
+		return false;
+	}
+
+	SkipBlanks(p, end);
+	if (!SkipChar(p, end, ':'))
+		return false;
+	SkipBlanks(p, end);
+	if (!ParseSeverityWord(p, end, &out->severity))
+		return false;
+	out->message.assign(p, end);
+	return true;
+}
+
+void ParseShaderLog(const char* log, size_t length, std::vector<ShaderDiagnostic>* diagnostics)
+{
+	diagnostics->clear();
+	ShaderDiagnostic diagnostic;
+	const char* end = log + length;
+	const char* p = log;
+	while (p < end)
+	{
+		const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (!lineEnd)
+			lineEnd = end;
+		const char* next = lineEnd + (lineEnd < end);
+
+		// the log length GL reports includes the terminator
+		while (lineEnd > p && (IsBlank(lineEnd[-1]) || lineEnd[-1] == '\0'))
+			lineEnd--;
+		SkipBlanks(p, lineEnd);
+
+		diagnostic = ShaderDiagnostic();
+		if (ParseUpperCaseLine(p, lineEnd, &diagnostic) || ParseNumberedLine(p, lineEnd, &diagnostic))
+			diagnostics->push_back(std::move(diagnostic));
+		p = next;
+	}
+}
+
+std::string FormatShaderDiagnostic(const ShaderDiagnostic& diagnostic)
+{
+	std::string result;
+	if (diagnostic.line > 0)
+	{
+		result += std::to_string(diagnostic.line);
+		if (diagnostic.column > 0)
+			result += ":" + std::to_string(diagnostic.column);
+		result += ": ";
+	}
+	result += diagnostic.severity == ShaderLogSeverity_Error ? "error: " : "warning: ";
+	result += diagnostic.message;
+	return result;
+}
+
+// The parsing main.cpp did before ParseShaderLog, kept to compare against in BenchmarkShaderLogParse
+static size_t ParseShaderLogRegex(std::string log)
+{
+	std::map<int, std::string> errorMarkers;
+	std::vector<std::string> errorStrings;
+	char* token = strtok(log.data(), "\n");
+	while (token != NULL)
+	{
+		if (std::regex_search(std::string(token), std::regex(R"(((ERROR: \d:\d*:) | (\s*:\s*error)))")))
+			errorStrings.emplace_back(std::string(token));
+		token = strtok(NULL, "\n");
+	}
+	for (auto& error : errorStrings)
+	{
+		std::string expression = R"((?::|\()\d*(?::|\)))";
+		auto regexp = std::regex(expression);
+		std::smatch match;
+		std::regex_search(error, match, regexp);
+		regexp = std::regex(R"(\d+)");
+		auto line = match[0].str();
+		std::smatch match2;
+		std::regex_search(line, match2, regexp);
+		line = match2[0].str();
+		int num = line.empty() ? 0 : std::stoi(line);
+		auto newError = std::regex_replace(error, std::regex(expression), (":" + std::to_string(num) + ":"));
+		errorMarkers.insert(std::make_pair(num, newError));
+	}
+	return errorStrings.size();
+}
+
+void BenchmarkShaderLogParse(int errorCount, float* parseMs, float* regexMs)
+{
+	std::string log;
+	for (int i = 1; i <= errorCount; i++)
+	{
+		std::string line = std::to_string(i);
+		log += "0:" + line + "(12): error: `undeclaredVariable' undeclared\n";
+		log += "0(" + line + ") : error C1008: undefined variable \"undeclaredVariable\"\n";
+		log += "ERROR: 0:" + line + ": 'undeclaredVariable' : undeclared identifier\n";
+	}
+	log += "ERROR: 3 compilation errors.  No code generated.\n";
+
+	std::vector<ShaderDiagnostic> diagnostics;
+	auto start = std::chrono::steady_clock::now();
+	ParseShaderLog(log.data(), log.size(), &diagnostics);
+	*parseMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	ParseShaderLogRegex(log);
+	*regexMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// Structured diagnostics from a shader info log. The formats of the drivers we have seen:
+//   Mesa                        0:12(5): error: `x' undeclared
+//   NVIDIA                      0(12) : error C1008: undefined variable "x"
+//   AMD, Intel, Apple, ANGLE    ERROR: 0:12: 'x' : undeclared identifier
+// Lines are editor lines thanks to the #line at the end of commonShaderSource.
+enum ShaderLogSeverity
+{
+	ShaderLogSeverity_Error,
+	ShaderLogSeverity_Warning,
+};
+
+struct ShaderDiagnostic
+{
+	int file = 0;		// source string number
+	int line = 0;		// 0 when the driver did not say, e.g. "ERROR: 0:?:"
+	int column = 0;		// 0 when unknown, only Mesa reports it
+	ShaderLogSeverity severity = ShaderLogSeverity_Error;
+	std::string message;
+};
+
+// One pass over the log, replacing the contents of diagnostics. Lines in no known format, like
+// the "2 compilation errors" summaries, are skipped.
+void ParseShaderLog(const char* log, size_t length, std::vector<ShaderDiagnostic>* diagnostics);
+// "12:5: error: message", the location left out when it is unknown
+std::string FormatShaderDiagnostic(const ShaderDiagnostic& diagnostic);
+
+// Times ParseShaderLog against the per-line std::regex parsing main.cpp used before, on a log
+// with errorCount errors in each driver format
+void BenchmarkShaderLogParse(int errorCount, float* parseMs, float* regexMs);
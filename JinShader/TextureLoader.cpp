@@ -0,0 +1,215 @@
+#include "TextureLoader.h"
+#include "Trace.h"
+#include <GL/glew.h>
+#include <string.h>
+
+static void DecodeWorker(JinShaderTextureLoader* loader)
+{
+	SetTraceThreadName("Texture Decoder");
+	std::unique_lock<std::mutex> lock(loader->mutex);
+	while (true)
+	{
+		loader->wake.wait(lock, [loader] { return !loader->requests.empty() || loader->quit; });
+		if (loader->quit)
+			break;
+
+		TextureDecode decode = std::move(loader->requests.front());
+		loader->requests.erase(loader->requests.begin());
+		lock.unlock();
+
+		{
+			TRACE_ZONE("Decode Image");
+			decode.success = DecodeImageFile(decode.path, &decode.image, &decode.error);
+		}
+
+		lock.lock();
+		loader->decoded.push_back(std::move(decode));
+		if (loader->notify)
+			loader->notify();
+	}
+}
+
+void InitTextureLoader(JinShaderTextureLoader* loader)
+{
+	glGenBuffers(1, &loader->pbo);
+	loader->worker = std::thread(DecodeWorker, loader);
+}
+
+void ShutdownTextureLoader(JinShaderTextureLoader* loader)
+{
+	if (loader->worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(loader->mutex);
+			loader->quit = true;
+		}
+		loader->wake.notify_one();
+		loader->worker.join();
+	}
+
+	for (auto& texture : loader->textures)
+	{
+		glDeleteTextures(1, &texture.channel.texture);
+		glDeleteTextures(1, &texture.staging);
+	}
+	loader->textures.clear();
+	loader->uploads.clear();
+	glDeleteBuffers(1, &loader->pbo);
+	loader->pbo = 0;
+}
+
+ChannelTexture* LoadChannelTexture(JinShaderTextureLoader* loader, const std::string& path)
+{
+	LoadedTexture* texture = 0;
+	for (auto& loaded : loader->textures)
+		if (loaded.path == path)
+			texture = &loaded;
+
+	if (!texture)
+	{
+		loader->textures.emplace_back();
+		texture = &loader->textures.back();
+		texture->path = path;
+	}
+
+	std::error_code ec;
+	auto writeTime = std::filesystem::last_write_time(path, ec);
+	// the old image stays up until the new one is uploaded
+	bool changed = !ec && writeTime != texture->write_time;
+	if (texture->loading || (!texture->failed && !changed && texture->channel.texture))
+		return &texture->channel;
+
+	// new file, edited on disk, or another try after a failed one
+	texture->write_time = writeTime;
+	texture->failed = false;
+	texture->loading = true;
+	{
+		std::lock_guard<std::mutex> lock(loader->mutex);
+		TextureDecode decode;
+		decode.target = texture;
+		decode.path = path;
+		loader->requests.push_back(std::move(decode));
+	}
+	loader->wake.notify_one();
+	return &texture->channel;
+}
+
+// Uploads rows of the texture through the PBO until the budget is used up. Returns false when
+// the texture is done.
+static bool UploadSlice(JinShaderTextureLoader* loader, LoadedTexture* texture, size_t* budget)
+{
+	int width = texture->image.width;
+	int height = texture->image.height;
+	size_t rowSize = (size_t)width * 4;
+	if (!texture->staging)
+	{
+		glGenTextures(1, &texture->staging);
+		glBindTexture(GL_TEXTURE_2D, texture->staging);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		texture->uploaded_rows = 0;
+	}
+
+	// at least one row per update, whatever the budget
+	int rows = (int)(*budget / rowSize);
+	if (rows < 1)
+		rows = 1;
+	if (rows > height - texture->uploaded_rows)
+		rows = height - texture->uploaded_rows;
+	size_t size = rows * rowSize;
+	*budget = size < *budget ? *budget - size : 0;
+
+	// orphan the last slice so mapping never waits on the GPU still reading it
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, loader->pbo);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+	auto mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+	if (mapped)
+	{
+		// images are stored top row first, GL wants the bottom row first
+		for (int i = 0; i < rows; i++)
+		{
+			int row = height - 1 - (texture->uploaded_rows + i);
+			memcpy(mapped + i * rowSize, texture->image.pixels.data() + row * rowSize, rowSize);
+		}
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindTexture(GL_TEXTURE_2D, texture->staging);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, texture->uploaded_rows, width, rows, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	texture->uploaded_rows += rows;
+	if (texture->uploaded_rows < height)
+		return true;
+
+	// only now swap it in, a half uploaded texture is never sampled
+	glDeleteTextures(1, &texture->channel.texture);
+	texture->channel.texture = texture->staging;
+	texture->channel.width = width;
+	texture->channel.height = height;
+	texture->channel.has_mips = false;
+	texture->channel.version++;
+	texture->staging = 0;
+	texture->image = DecodedImage();
+	texture->loading = false;
+	return false;
+}
+
+void UpdateTextureLoader(JinShaderTextureLoader* loader)
+{
+	TRACE_ZONE("Texture Upload");
+	int maxSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	{
+		std::lock_guard<std::mutex> lock(loader->mutex);
+		for (auto& decode : loader->decoded)
+		{
+			LoadedTexture* texture = decode.target;
+			if (decode.success && (decode.image.width > maxSize || decode.image.height > maxSize))
+			{
+				decode.success = false;
+				decode.error = "Image is larger than GL_MAX_TEXTURE_SIZE";
+			}
+
+			if (!decode.success)
+			{
+				texture->failed = true;
+				texture->loading = false;
+				loader->errors.push_back(decode.path + ": " + decode.error);
+				continue;
+			}
+			texture->image = std::move(decode.image);
+			loader->uploads.push_back(texture);
+		}
+		loader->decoded.clear();
+	}
+
+	size_t budget = loader->upload_budget;
+	while (!loader->uploads.empty() && budget > 0)
+	{
+		if (!UploadSlice(loader, loader->uploads.front(), &budget))
+			loader->uploads.erase(loader->uploads.begin());
+	}
+}
+
+bool IsTextureLoaderBusy(JinShaderTextureLoader* loader)
+{
+	for (auto& texture : loader->textures)
+		if (texture.loading)
+			return true;
+	return false;
+}
+
+bool HasTextureUploads(JinShaderTextureLoader* loader)
+{
+	return !loader->uploads.empty();
+}
+
+bool PollTextureError(JinShaderTextureLoader* loader, std::string* error)
+{
+	if (loader->errors.empty())
+		return false;
+	*error = std::move(loader->errors.front());
+	loader->errors.erase(loader->errors.begin());
+	return true;
+}
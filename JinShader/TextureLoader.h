@@ -0,0 +1,72 @@
+#pragma once
+#include "Renderer.h"
+#include "ImageDecoder.h"
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Loads image files for the iChannels without ever blocking the frame loop. Files are decoded
+// on a worker thread, then streamed into their texture through a pixel unpack buffer a slice
+// per frame, so even an 8K image only costs a few milliseconds each frame until it is done.
+struct LoadedTexture
+{
+	std::string path;
+	ChannelTexture channel;
+	bool loading = false;
+	bool failed = false;
+	std::filesystem::file_time_type write_time;	// of the file when its last decode was queued
+
+	// UI thread only, the decoded image while it is being uploaded
+	DecodedImage image;
+	unsigned int staging = 0;
+	int uploaded_rows = 0;
+};
+
+struct TextureDecode
+{
+	LoadedTexture* target = 0;
+	std::string path;
+	DecodedImage image;
+	std::string error;
+	bool success = false;
+};
+
+struct JinShaderTextureLoader
+{
+	std::list<LoadedTexture> textures;	// one per file, never moves so channels can point into it
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	void (*notify)() = 0;	// called from the worker after each decode, e.g. to wake the event loop
+
+	// guarded by mutex
+	std::vector<TextureDecode> requests;
+	std::vector<TextureDecode> decoded;
+	bool quit = false;
+
+	// UI thread only
+	std::vector<LoadedTexture*> uploads;	// oldest first
+	std::vector<std::string> errors;
+	unsigned int pbo = 0;
+	size_t upload_budget = 16 * 1024 * 1024;	// bytes streamed into textures per update
+};
+
+void InitTextureLoader(JinShaderTextureLoader* loader);
+void ShutdownTextureLoader(JinShaderTextureLoader* loader);
+
+// Returns immediately, the texture stays empty until the file is decoded and uploaded.
+// Loading the same path again shares the texture, and decodes it again if the file changed since.
+ChannelTexture* LoadChannelTexture(JinShaderTextureLoader* loader, const std::string& path);
+
+// Picks up decoded images and uploads the next slice, call once per frame on the UI thread
+void UpdateTextureLoader(JinShaderTextureLoader* loader);
+// True until every load is decoded and uploaded, for headless runs that have to wait for them
+bool IsTextureLoaderBusy(JinShaderTextureLoader* loader);
+// True while decoded images still have slices to upload. Decodes wake the loop through notify instead.
+bool HasTextureUploads(JinShaderTextureLoader* loader);
+// Returns true while there are failed loads to report
+bool PollTextureError(JinShaderTextureLoader* loader, std::string* error);
@@ -0,0 +1,104 @@
+#include "Trace.h"
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static std::mutex traceThreadsMutex;
+static TraceThread* traceThreads = 0;
+static uint32_t traceThreadCount = 0;
+static thread_local TraceThread* traceThread = 0;
+
+// Buffers are never freed, a finished thread's events stay in the trace
+static TraceThread* GetTraceThread()
+{
+	if (!traceThread)
+	{
+		TraceThread* thread = new TraceThread();
+		std::lock_guard<std::mutex> lock(traceThreadsMutex);
+		thread->id = ++traceThreadCount;
+		snprintf(thread->name, sizeof(thread->name), "Thread %u", thread->id);
+		thread->next = traceThreads;
+		traceThreads = thread;
+		traceThread = thread;
+	}
+	return traceThread;
+}
+
+uint64_t GetTraceTime()
+{
+	static const auto epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void AddTraceEvent(const char* name, uint64_t startNs, uint64_t endNs)
+{
+	TraceThread* thread = GetTraceThread();
+	uint64_t head = thread->head.load(std::memory_order_relaxed);
+	TraceEvent& event = thread->events[head % traceRingSize];
+	event.name = name;
+	event.start_ns = startNs;
+	event.duration_ns = endNs - startNs;
+	// publishes the event to SaveTrace
+	thread->head.store(head + 1, std::memory_order_release);
+}
+
+void SetTraceThreadName(const char* name)
+{
+	TraceThread* thread = GetTraceThread();
+	std::lock_guard<std::mutex> lock(traceThreadsMutex);
+	snprintf(thread->name, sizeof(thread->name), "%s", name);
+}
+
+static void WriteJsonString(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (; *text; text++)
+	{
+		if (*text == '"' || *text == '\\')
+			fputc('\\', file);
+		if ((unsigned char)*text >= 0x20)
+			fputc(*text, file);
+	}
+	fputc('"', file);
+}
+
+bool SaveTrace(const char* path)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+
+	std::vector<TraceEvent> events;
+	std::lock_guard<std::mutex> lock(traceThreadsMutex);
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (TraceThread* thread = traceThreads; thread; thread = thread->next)
+	{
+		fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", thread->id);
+		WriteJsonString(file, thread->name);
+		fprintf(file, "}}");
+		first = false;
+
+		// copy first, then drop whatever the thread overwrote while we were copying. That includes
+		// the slot of event newHead, which the thread may still be filling.
+		uint64_t head = thread->head.load(std::memory_order_acquire);
+		uint64_t begin = head > traceRingSize ? head - traceRingSize : 0;
+		events.clear();
+		for (uint64_t i = begin; i < head; i++)
+			events.push_back(thread->events[i % traceRingSize]);
+		uint64_t newHead = thread->head.load(std::memory_order_acquire);
+		size_t overwritten = newHead + 1 > traceRingSize + begin ? (size_t)(newHead + 1 - traceRingSize - begin) : 0;
+
+		for (size_t i = overwritten; i < events.size(); i++)
+		{
+			const TraceEvent& event = events[i];
+			fprintf(file, ",\n{\"ph\":\"X\",\"name\":");
+			WriteJsonString(file, event.name);
+			fprintf(file, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", thread->id, event.start_ns / 1000.0, event.duration_ns / 1000.0);
+		}
+	}
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
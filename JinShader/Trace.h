@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <stdint.h>
+
+// Timeline of scoped zones from every thread, kept in memory so a hitch can be saved after the
+// fact and opened in Perfetto or chrome://tracing. Each thread records into its own ring buffer
+// with no locks, only registering a new thread takes one.
+
+struct TraceEvent
+{
+	const char* name;	// must outlive the trace, normally a string literal
+	uint64_t start_ns;
+	uint64_t duration_ns;
+};
+
+// ~2 minutes of the main loop at 60 fps, older events are overwritten
+const uint32_t traceRingSize = 1 << 17;
+
+struct TraceThread
+{
+	TraceEvent events[traceRingSize];
+	std::atomic<uint64_t> head{ 0 };	// total events written, only the owning thread stores it
+	uint32_t id = 0;
+	char name[32] = {};
+	TraceThread* next = 0;
+};
+
+uint64_t GetTraceTime();
+void AddTraceEvent(const char* name, uint64_t startNs, uint64_t endNs);
+// Shows up as the track name, call from the thread itself
+void SetTraceThreadName(const char* name);
+
+// Writes the buffered events of all threads as Chrome trace JSON
+bool SaveTrace(const char* path);
+
+struct TraceZone
+{
+	const char* name;
+	uint64_t start;
+
+	TraceZone(const char* zoneName) : name(zoneName), start(GetTraceTime()) {}
+	~TraceZone() { AddTraceEvent(name, start, GetTraceTime()); }
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
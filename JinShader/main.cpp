@@ -1,5 +1,16 @@
 #include "JinShader.h"
+#include "Renderer.h"
+#include "Headless.h"
+#include "ShaderCompiler.h"
+#include "ShaderLog.h"
+#include "ProgramCache.h"
+#include "TextureLoader.h"
+#include "GpuTimer.h"
+#include "DynamicResolution.h"
+#include "Profiler.h"
+#include "Trace.h"
 #include "texteditor/TextEditor.h"
+#include <chrono>
 
 
 //this is borrowed from the imgui_demo.cpp
@@ -125,11 +136,138 @@ struct ConsoleLog
 
 static ConsoleLog consoleLogger;
 
+static const double validateDelay = 0.25;	// seconds without typing before the code is checked
 
+// One editor tab per render pass
+struct PassEditor
+{
+	TextEditor editor;
+	TextEditor::Diagnostics markers;	// shown by editor, from diagnostics
+	uint64_t key = 0;	// ProgramCache key of the program the pass is running
+	std::string source;	// reused by every save and validation
+	char channel_paths[renderChannelCount][260] = {};
+
+	// what the driver said about the source with key log_key, from a build or a validation
+	std::string log;
+	std::vector<ShaderDiagnostic> diagnostics;
+	uint64_t log_key = 0;
+	bool log_failed = false;
+	uint64_t validate_key = 0;		// newest source sent off, older validations are ignored
+	double validate_time = 0.0;		// glfwGetTime to validate the edited text at, 0 when up to date
+};
 
-int main()
+// The pass runs the program cached under key from now on, so the cache must keep it
+static void SetPassKey(JinShaderProgramCache* cache, PassEditor* passEditor, uint64_t key)
+{
+	PinCachedProgram(cache, key);
+	if (passEditor->key)
+		UnpinCachedProgram(cache, passEditor->key);
+	passEditor->key = key;
+}
+
+// Keeps log and rebuilds the editor markers from it
+static void SetPassLog(PassEditor* passEditor, uint64_t key, bool failed, const std::string& log)
+{
+	passEditor->log = log;
+	passEditor->log_key = key;
+	passEditor->log_failed = failed;
+	ParseShaderLog(log.data(), log.size(), &passEditor->diagnostics);
+
+	auto& entries = passEditor->markers.mEntries;
+	entries.resize(passEditor->diagnostics.size());
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		const ShaderDiagnostic& diagnostic = passEditor->diagnostics[i];
+		TextEditor::Diagnostic& entry = entries[i];
+		entry.mLine = diagnostic.line;
+		// driver columns are 1 based characters, the word there gets the squiggle
+		entry.mStart = diagnostic.column - 1;
+		entry.mEnd = -1;
+		entry.mSeverity = diagnostic.severity == ShaderLogSeverity_Error ? TextEditor::DiagnosticSeverity::Error : TextEditor::DiagnosticSeverity::Warning;
+		entry.mMessage = FormatShaderDiagnostic(diagnostic);
+	}
+	passEditor->markers.mVersion++;
+}
+
+static void LogCompileErrors(const char* passName, const std::vector<ShaderDiagnostic>& diagnostics, const std::string& log)
+{
+	for (auto& diagnostic : diagnostics)
+		consoleLogger.AddLog("%s: Shader Compilation Failed %s", passName, FormatShaderDiagnostic(diagnostic).c_str());
+	// a driver we do not know the format of, better the raw log than nothing
+	if (diagnostics.empty())
+		consoleLogger.AddLog("%s: Shader Compilation Failed %s", passName, log.c_str());
+}
+
+// Source and sampler settings of one iChannel, a button that opens them in a popup
+static void ChannelSettings(JinShaderRenderer* renderer, JinShaderTextureLoader* textureLoader, PassEditor* passEditor, int pass, int channel)
 {
+	RenderPass* renderPass = &renderer->passes[pass];
+	int input = renderPass->channels[channel];
+	const char* sourceName = input == channelInputTexture ? "Texture" : input == channelInputNone ? "None" : renderPassNames[input];
+	char label[64];
+	snprintf(label, sizeof(label), "iChannel%d: %s###iChannel%d", channel, sourceName, channel);
+	if (channel > 0)
+		ImGui::SameLine();
+	if (ImGui::Button(label))
+		ImGui::OpenPopup(label);
+	if (!ImGui::BeginPopup(label))
+		return;
+
+	const char* sourceNames[] = { "None", "Buffer A", "Buffer B", "Buffer C", "Buffer D", "Texture" };
+	const int textureSource = IM_ARRAYSIZE(sourceNames) - 1;
+	int selected = input == channelInputTexture ? textureSource : input + 1;
+	ImGui::SetNextItemWidth(200);
+	if (ImGui::Combo("Source", &selected, sourceNames, IM_ARRAYSIZE(sourceNames)))
+	{
+		if (selected == textureSource)
+		{
+			SetPassChannelTexture(renderer, pass, channel, 0);
+			SetPassChannelSampler(renderer, pass, channel, ChannelFilter_Mipmap, ChannelWrap_Repeat);
+		}
+		else
+		{
+			SetPassChannel(renderer, pass, channel, selected - 1);
+			SetPassChannelSampler(renderer, pass, channel, ChannelFilter_Linear, ChannelWrap_Clamp);
+		}
+	}
 
+	if (renderPass->channels[channel] == channelInputTexture)
+	{
+		char* path = passEditor->channel_paths[channel];
+		ImGui::SetNextItemWidth(200);
+		bool load = ImGui::InputText("File", path, sizeof(passEditor->channel_paths[channel]), ImGuiInputTextFlags_EnterReturnsTrue);
+		ImGui::SameLine();
+		load |= ImGui::Button("Load");
+		if (load && path[0])
+			SetPassChannelTexture(renderer, pass, channel, LoadChannelTexture(textureLoader, path));
+
+		ChannelTexture* texture = renderPass->channel_textures[channel];
+		if (texture && texture->texture)
+			ImGui::TextDisabled("%d x %d", texture->width, texture->height);
+		else if (texture)
+			ImGui::TextDisabled("Loading...");
+	}
+
+	int filter = renderPass->channel_filters[channel];
+	int wrap = renderPass->channel_wraps[channel];
+	ImGui::SetNextItemWidth(200);
+	bool changed = ImGui::Combo("Filter", &filter, channelFilterNames, ChannelFilter_Count);
+	ImGui::SetNextItemWidth(200);
+	changed |= ImGui::Combo("Wrap", &wrap, channelWrapNames, ChannelWrap_Count);
+	if (changed)
+		SetPassChannelSampler(renderer, pass, channel, filter, wrap);
+	ImGui::EndPopup();
+}
+
+
+int main(int argc, char** argv)
+{
+	HeadlessOptions headlessOptions;
+	bool badArguments = false;
+	if (ParseHeadlessOptions(argc, argv, &headlessOptions, &badArguments))
+		return badArguments ? 1 : RunHeadless(headlessOptions);
+
+	SetTraceThreadName("Main");
 	JinShaderState* state = InitJinShader();
 	state->window_width = 1200;
 	state->window_height = 675;
@@ -137,58 +275,25 @@ int main()
 	InitWindow(state);
 	InitImGui(state);
 	
-	unsigned int program = 0, shader = 0;
-	int codeBufferSize = 1024 * 1024 * 4;
-	char* codeBuffer = (char*)calloc(1, codeBufferSize);
-
-	unsigned int fbo;
-	unsigned int colorAttachMent = 0;
-	glGenFramebuffers(1, &fbo);
-
-	const char* vertexShaderSource = 
-		"#version 330 core\n"
-		"layout(location = 0) in vec4 in_position;\n"
-		"void main()\n"
-		"{\n"
-			"gl_Position = in_position;\n"
-		"}\n";
+	JinShaderRenderer renderer;
+	InitRenderer(&renderer);
 
-	auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShader, 1, &vertexShaderSource, 0);
-	glCompileShader(vertexShader);
-	int result = 0;
-	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &result);
+	JinShaderProgramCache programCache;
+	InitProgramCache(&programCache, GetProgramCacheDirectory().c_str(), 32);
 
-	if (!result)
-	{
-		int len = 0;
-		glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &len);
-		char* log = (char*)malloc(len);
-		glGetShaderInfoLog(vertexShader, len, 0, log);
-		printf("Vertex Shader Compilation Failed! : %s\n", log);
-		free(log);
-	}
+	JinShaderProfiler profiler;
+	GpuTimer shaderTimer, uiTimer;
+	InitGpuTimer(&shaderTimer);
+	InitGpuTimer(&uiTimer);
+	JinShaderDynamicResolution dynamicResolution;
 
-	const char* commonShaderSource =
-		"#version 330 core\n"
-		"out vec4 FinalColor;\n"
-		"in vec4 fragCoord;\n"
-		"uniform vec3 iResolution;\n"           // viewport resolution (in pixels)
-		"uniform float iTime;\n"           // shader playback time (in seconds)
-		"uniform float iTimeDelta;\n"          // render time (in seconds)
-		"uniform int iFrame;\n"         // shader playback frame
-		//"uniform float iChannelTime[4];\n"      // channel playback time (in seconds)
-		//"uniform vec3 iChannelResolution[4];\n" // channel resolution (in pixels)
-		"uniform vec4 iMouse;\n"                // mouse pixel coords. xy: current (if MLB down), zw: click
-		//"uniform vec4 iDate;\n"                 // (year, month, day, time in seconds)
-		//"uniform float iSampleRate;\n";           // sound sample rate (i.e., 44100)
-		"void mainImage( out vec4 fragColor, in vec2 fragCoord );\n"
-		"void main()\n"
-		"{\n"
-		"\tmainImage(FinalColor, gl_FragCoord.xy);\n"
-		"}\n";
+	JinShaderTextureLoader textureLoader;
+	InitTextureLoader(&textureLoader);
+	textureLoader.notify = glfwPostEmptyEvent;
 
-	auto commonShaderSourceLen = strlen(commonShaderSource);
+	JinShaderCompiler compiler;
+	GLFWwindow* buildContext = CreateSharedContext(state);
+	InitShaderCompiler(&compiler, buildContext, buildContext ? CreateSharedContext(state) : 0, renderer.stages, programCache.directory);
 
 	const char* initialCode = 
 		"void mainImage( out vec4 fragColor, in vec2 fragCoord )\n"
@@ -200,129 +305,213 @@ int main()
 		"\t// Output to screen\n"
 		"\tfragColor = vec4(col, 1.0);\n"
 		"}\n";
-	strcat(codeBuffer, initialCode);
+	const char* initialBufferCode =
+		"void mainImage( out vec4 fragColor, in vec2 fragCoord )\n"
+		"{\n"
+		"\tfragColor = vec4(0.0, 0.0, 0.0, 1.0);\n"
+		"}\n";
 
-	float iTime = 0, iTimeDelta = 0;
-	int iTimeLocation = 0, iResolutionLocation = 0, iTimeDeltaLocation = 0, iFrameLocation = 0, iChannelTimeLocation = 0, iChannelResolutionLocation = 0, iMouseLocation = 0, iDateLocation = 0, iSampleRateLocation = 0;
-	int iFrame = 0;
+	ShaderInputs inputs;
 
 	float framebufferSizeX = 0;
 	float framebufferSizeY = 0;
 	float framebufferSizeXLast = 0;
 	float framebufferSizeYLast = 0;
 
-	float quadVerts[4*4] = 
-	{
-		-1,  1,  0, 1,
-		-1, -1,  0, 1,
-		 1, -1,  0, 1,
-		 1,  1,  0, 1
-	};
-	unsigned int vbo;
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 4 * 4, quadVerts, GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 4, GL_FLOAT, 0, 0, 0);
-	glEnableVertexAttribArray(0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
 	bool showAboutImGui = false;
 	bool showAboutJinShader = false;
 	bool showCode = true;
 	bool showLog = true;
+	bool showProfiler = false;
 
-	TextEditor editor;
-	editor.SetLanguageDefinition(TextEditor::LanguageDefinition::GLSL());
-	editor.SetText(codeBuffer);
-	editor.SetShowWhitespaces(false);
-	editor.SetImGuiChildIgnored(false);
-	TextEditor::ErrorMarkers errorMarkers;
+	PassEditor passEditors[RenderPass_Count];
+	for (int i = 0; i < RenderPass_Count; i++)
+	{
+		TextEditor& editor = passEditors[i].editor;
+		editor.SetLanguageDefinition(TextEditor::LanguageDefinition::GLSL());
+		editor.SetText(i == RenderPass_Image ? initialCode : initialBufferCode);
+		editor.SetShowWhitespaces(false);
+		editor.SetImGuiChildIgnored(true);
+		editor.SetColorizeNotify(glfwPostEmptyEvent);
+		editor.SetDiagnostics(&passEditors[i].markers);
+	}
 
 	while (state->window_is_open)
 	{
-		JinShaderUpdate(state);
-		if (state->has_focus)
 		{
-			iFrame++;
-			iTime = (float)glfwGetTime();
-			glClear(GL_COLOR_BUFFER_BIT);
-
-			ImGui_ImplOpenGL3_NewFrame();
-			ImGui_ImplGlfw_NewFrame();
-			ImGui::NewFrame();
-
-			ImGui::DockSpaceOverViewport();
-			if (ImGui::BeginMainMenuBar())
+			TRACE_ZONE("Wait Events");
+			JinShaderUpdate(state);
+		}
+		BeginProfileZone(&profiler, ProfileZone_Frame);
+		inputs.frame++;
+		float time = (float)glfwGetTime();
+		inputs.time_delta = time - inputs.time;
+		inputs.time = time;
+
+		auto now = std::chrono::system_clock::now();
+		time_t nowSeconds = std::chrono::system_clock::to_time_t(now);
+		tm* local = localtime(&nowSeconds);
+		auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+		inputs.date[0] = (float)(local->tm_year + 1900);
+		inputs.date[1] = (float)local->tm_mon;
+		inputs.date[2] = (float)local->tm_mday;
+		inputs.date[3] = local->tm_hour * 3600.0f + local->tm_min * 60.0f + local->tm_sec + milliseconds / 1000.0f;
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		BeginProfileZone(&profiler, ProfileZone_ImGuiBuild);
+		ImGui_ImplOpenGL3_NewFrame();
+		ImGui_ImplGlfw_NewFrame();
+		ImGui::NewFrame();
+
+		ImGui::DockSpaceOverViewport();
+		if (ImGui::BeginMainMenuBar())
+		{
+			if (ImGui::BeginMenu("File"))
 			{
-				if (ImGui::BeginMenu("File"))
+				if (ImGui::MenuItem("Save Trace"))
 				{
-					if (ImGui::MenuItem("Exit"))
-						state->want_exit = true;
-					ImGui::EndMenu();
+					// everything still in the ring buffers, roughly the last two minutes
+					char tracePath[64];
+					strftime(tracePath, sizeof(tracePath), "jinshader_trace_%Y%m%d_%H%M%S.json", localtime(&nowSeconds));
+					if (SaveTrace(tracePath))
+						consoleLogger.AddLog("Saved trace to %s, open it in Perfetto or chrome://tracing\n", tracePath);
+					else
+						consoleLogger.AddLog("Failed to save trace to %s\n", tracePath);
 				}
+				ImGui::Separator();
+				if (ImGui::MenuItem("Exit"))
+					state->want_exit = true;
+				ImGui::EndMenu();
+			}
 
-				if (ImGui::BeginMenu("View"))
+			if (ImGui::BeginMenu("View"))
+			{
+				ImGui::MenuItem("Show Code", 0, &showCode);
+				ImGui::MenuItem("Show Log", 0, &showLog); 
+				ImGui::MenuItem("Show Profiler", 0, &showProfiler);
+				ImGui::SetNextItemWidth(100);
+				ImGui::SliderFloat("Background FPS", &state->background_fps, 0.0f, 60.0f, "%.0f");
+				ImGui::Separator();
+				if (ImGui::MenuItem("Dynamic Resolution", 0, &dynamicResolution.enabled))
 				{
-					ImGui::MenuItem("Show Code", 0, &showCode);
-					ImGui::MenuItem("Show Log", 0, &showLog); 
-
-					ImGui::EndMenu();
+					dynamicResolution.scale = 1.0f;
+					state->want_update = true;
 				}
+				ImGui::SetNextItemWidth(100);
+				ImGui::SliderFloat("Target ms", &dynamicResolution.target_ms, 4.0f, 100.0f, "%.1f");
+				ImGui::SetNextItemWidth(100);
+				ImGui::SliderFloat("Min Scale", &dynamicResolution.min_scale, 0.1f, 1.0f, "%.2f");
 
-				if (ImGui::BeginMenu("About"))
+				ImGui::EndMenu();
+			}
+
+			if (ImGui::BeginMenu("About"))
+			{
+				if (ImGui::MenuItem("JinShader"))
 				{
-					if (ImGui::MenuItem("JinShader"))
-					{
-						showAboutJinShader = true;
-					}
-					if (ImGui::MenuItem("Dear ImGui"))
-					{
-						showAboutImGui = true;
-					}
-					ImGui::EndMenu();
+					showAboutJinShader = true;
 				}
-				ImGui::EndMainMenuBar();
+				if (ImGui::MenuItem("Dear ImGui"))
+				{
+					showAboutImGui = true;
+				}
+				ImGui::EndMenu();
 			}
 
-			//ImGui::ShowDemoWindow();
+			if (IsShaderCompileRunning(&compiler))
+				ImGui::TextDisabled("Compiling...");
+			if (dynamicResolution.enabled)
+				ImGui::TextDisabled("%d%% %.1f ms", (int)(dynamicResolution.scale * 100.0f + 0.5f), dynamicResolution.gpu_ms);
+			ImGui::EndMainMenuBar();
+		}
 
-			if (showAboutImGui)
+		//ImGui::ShowDemoWindow();
+
+		if (showAboutImGui)
+		{
+			ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.2f);
+			ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+			ImGui::ShowAboutWindow(&showAboutImGui);
+		}
+		if (showAboutJinShader)
+		{
+			ImGui::OpenPopup("About JinShader");
+			ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f);
+			ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+			if (ImGui::BeginPopupModal("About JinShader", &showAboutJinShader, ImGuiWindowFlags_AlwaysAutoResize))
 			{
-				ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.2f);
-				ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
-				ImGui::ShowAboutWindow(&showAboutImGui);
+				ImGui::Text("Version 0.4 pre-release");
+				ImGui::Separator();
+				ImGui::Text("Author: Ahsan Ullah Sarbaz");
+				ImGui::EndPopup();
 			}
-			if (showAboutJinShader)
+		}
+
+		if (showCode)
+		{
+			ImGui::Begin("Code", &showCode);
+			if (ImGui::BeginTabBar("Passes"))
 			{
-				ImGui::OpenPopup("About JinShader");
-				ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f);
-				ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
-				if (ImGui::BeginPopupModal("About JinShader", &showAboutJinShader, ImGuiWindowFlags_AlwaysAutoResize))
+				// Image first, the buffers feeding it after
+				int tabOrder[RenderPass_Count] = { RenderPass_Image, RenderPass_BufferA, RenderPass_BufferB, RenderPass_BufferC, RenderPass_BufferD };
+				for (int pass : tabOrder)
 				{
-					ImGui::Text("Version 0.4 pre-release");
-					ImGui::Separator();
-					ImGui::Text("Author: Ahsan Ullah Sarbaz");
-					ImGui::EndPopup();
+					bool isImage = pass == RenderPass_Image;
+					bool open = renderer.passes[pass].enabled;
+					if (!open)
+						continue;
+					if (ImGui::BeginTabItem(renderPassNames[pass], isImage ? 0 : &open))
+					{
+						for (int c = 0; c < renderChannelCount; c++)
+							ChannelSettings(&renderer, &textureLoader, &passEditors[pass], pass, c);
+
+						PassEditor& passEditor = passEditors[pass];
+						ImGui::BeginChild("Editor", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar);
+						BeginProfileZone(&profiler, ProfileZone_Editor);
+						passEditor.editor.Render(renderPassNames[pass]);
+						EndProfileZone(&profiler, ProfileZone_Editor);
+						if (passEditor.editor.IsTextChanged())
+							passEditor.validate_time = glfwGetTime() + validateDelay;
+						AddProfileTime(&profiler, ProfileZone_Colorize, passEditor.editor.GetColorizeMilliseconds());
+						ImGui::EndChild();
+						ImGui::EndTabItem();
+					}
+					if (!open)
+						SetPassEnabled(&renderer, pass, false);
 				}
-			}
 
-			if (showCode)
-			{
-				editor.SetErrorMarkers(errorMarkers);
-				editor.Render("Code", &showCode);
+				if (ImGui::TabItemButton("+", ImGuiTabItemFlags_Trailing | ImGuiTabItemFlags_NoTooltip))
+					ImGui::OpenPopup("Add Pass");
+				if (ImGui::BeginPopup("Add Pass"))
+				{
+					for (int pass = 0; pass < renderBufferCount; pass++)
+					{
+						if (renderer.passes[pass].enabled || !ImGui::MenuItem(renderPassNames[pass]))
+							continue;
+						SetPassEnabled(&renderer, pass, true);
+						state->want_save = true;
+					}
+					ImGui::EndPopup();
+				}
+				ImGui::EndTabBar();
 			}
+			ImGui::End();
+		}
 
-			ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
-			
-			if (showLog)
-			{
-				consoleLogger.Draw("Log", &showLog);
-			}
-			
+		ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2{ 0, 0 });
+		
+		if (showLog)
+		{
+			consoleLogger.Draw("Log", &showLog);
+		}
+		
 
-			ImGui::Begin("View", 0);
-			auto avail = ImGui::GetContentRegionAvail();
-			ImGui::Image(reinterpret_cast<void*>(colorAttachMent), avail, { 0,1 }, {1,0});
+		// collapsed or behind another dock tab, nobody would see what we render
+		bool viewVisible = ImGui::Begin("View", 0);
+		auto avail = ImGui::GetContentRegionAvail();
+		if (viewVisible)
+		{
+			ImGui::Image(reinterpret_cast<void*>((intptr_t)GetOutputTexture(&renderer)), avail, { 0,1 }, {1,0});
 			framebufferSizeX = avail.x;
 			framebufferSizeY = avail.y;
 
@@ -335,177 +524,249 @@ int main()
 			framebufferSizeYLast = framebufferSizeY;
 			state->fb_width = (int)framebufferSizeX;
 			state->fb_height = (int)framebufferSizeY;
+		}
 
-			ImGui::End();
-			ImGui::PopStyleVar();
+		ImGui::End();
+		ImGui::PopStyleVar();
 
-			if (state->want_exit)
+		if (state->want_exit)
+		{
+			ImGui::OpenPopup("Exit?");
+			ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f);
+			ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
+			if (ImGui::BeginPopupModal("Exit?", NULL, ImGuiWindowFlags_AlwaysAutoResize))
 			{
-				ImGui::OpenPopup("Exit?");
-				ImVec2 center(ImGui::GetIO().DisplaySize.x * 0.5f, ImGui::GetIO().DisplaySize.y * 0.5f);
-				ImGui::SetNextWindowPos(center, ImGuiCond_Appearing, ImVec2(0.5f, 0.5f));
-				if (ImGui::BeginPopupModal("Exit?", NULL, ImGuiWindowFlags_AlwaysAutoResize))
+				ImGui::Text("Are You Sure Want to Exit?");
+				ImGui::Separator();
+	
+				if (ImGui::Button("OK", ImVec2(120, 0)))
 				{
-					ImGui::Text("Are You Sure Want to Exit?");
-					ImGui::Separator();
-		
-					if (ImGui::Button("OK", ImVec2(120, 0)))
-					{
-						ImGui::CloseCurrentPopup();
-						state->want_exit = false;
-						glfwSetWindowShouldClose(state->window, 1);
-						state->window_is_open = false;
-					}
+					ImGui::CloseCurrentPopup();
+					state->want_exit = false;
+					glfwSetWindowShouldClose(state->window, 1);
+					state->window_is_open = false;
+				}
 
-					ImGui::SetItemDefaultFocus();
-					ImGui::SameLine();
-					if (ImGui::Button("Cancel", ImVec2(120, 0)))
-					{ 
-						ImGui::CloseCurrentPopup();
-						state->want_exit = false;
-					}
-					ImGui::EndPopup();
+				ImGui::SetItemDefaultFocus();
+				ImGui::SameLine();
+				if (ImGui::Button("Cancel", ImVec2(120, 0)))
+				{ 
+					ImGui::CloseCurrentPopup();
+					state->want_exit = false;
 				}
+				ImGui::EndPopup();
 			}
+		}
+		EndProfileZone(&profiler, ProfileZone_ImGuiBuild);
 
-
-			if (state->want_save)
+		if (state->want_save)
+		{
+			for (int pass = 0; pass < RenderPass_Count; pass++)
 			{
-				auto sourceLen = editor.GetText().size();
-				char* shaderSource = (char*)calloc(1, sourceLen + commonShaderSourceLen);
-				
-				std::string editorString = editor.GetText();
-				const char* editorCode = editorString.c_str();
-				//strcpy(shaderSource, commonShaderSource);
-				strcat(shaderSource, commonShaderSource);
-				strcat(shaderSource, editorCode);
-
-				if(shader)
-					glDeleteShader(shader);
-				if(program)
-					glDeleteProgram(program);
-
-				program = glCreateProgram();
-				shader = glCreateShader(GL_FRAGMENT_SHADER);
-				glShaderSource(shader, 1, &shaderSource, 0);
-				glCompileShader(shader);
-				int result = 0;
-				glGetShaderiv(shader, GL_COMPILE_STATUS, &result);
-				state->compile_success = (bool)result;
-				if (!result)
+				if (!renderer.passes[pass].enabled)
+					continue;
+
+				PassEditor& passEditor = passEditors[pass];
+				std::string& editorString = passEditor.source;
+				passEditor.editor.GetText(editorString);
+				uint64_t key = HashShaderSource(&programCache, editorString);
+				passEditor.validate_key = key;
+				passEditor.validate_time = 0.0;
+				unsigned int cachedProgram = FindCachedProgram(&programCache, key);
+				if (cachedProgram)
 				{
-					int len = 0;
-					glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &len);
-					char* log = (char*)malloc(len);
-					glGetShaderInfoLog(shader, len, 0, log);
-					std::vector<std::string> errorStrings;
-					char* token = strtok(log, "\n");
-					while (token != NULL)
-					{
-						if(std::regex_search(std::string(token), std::regex(R"(((ERROR: \d:\d*:) | (\s*:\s*error)))")))
-							errorStrings.emplace_back(std::string(token));
-						token = strtok(NULL, "\n");
-					}
-					for (auto& error : errorStrings)
-					{
-						std::string expression = R"((?::|\()\d*(?::|\)))";
-						auto regexp = std::regex(expression);
-						std::smatch match;
-						std::regex_search(error, match, regexp);
-						regexp = std::regex(R"(\d+)");
-						auto line = match[0].str();
-						std::smatch match2;
-						std::regex_search(line, match2, regexp);
-						line = match2[0].str();
-						int num = std::stoi(line) - 13;
-						auto newError = std::regex_replace(error, std::regex(expression), (":" + std::to_string(num) + ":"));
-						errorMarkers.insert(std::make_pair<int, std::string>(int(num), std::string(newError)));
-						consoleLogger.AddLog("Shader Compilation Failed %s", newError.c_str());
-					}
-
-					free(log);
+					// linked before in this session, no need to go through the compiler at all
+					CancelShaderCompile(&compiler, pass);
+					state->compile_success = true;
+					SetPassLog(&passEditor, key, false, std::string());
+					SetPassKey(&programCache, &passEditor, key);
+					SetPassProgram(&renderer, pass, cachedProgram, FindShaderInputs(editorString.c_str()));
 				}
-				glAttachShader(program, vertexShader);
-				glAttachShader(program, shader);
-				glLinkProgram(program);
-				glGetProgramiv(program, GL_LINK_STATUS, &result);
-				if (!result)
+				else if (key == passEditor.log_key && passEditor.log_failed)
 				{
-					int len = 0;
-					glGetProgramiv(program, GL_INFO_LOG_LENGTH, &len);
-					char* log = (char*)malloc(len);
-					glGetProgramInfoLog(program, len, 0, log);
-					consoleLogger.AddLog("Shader Link Failed %s", log);
-					printf("Shader Link Failed! : %s\n", log);
-					free(log);
+					// validation already saw this source fail, the full build would only say the same
+					CancelShaderCompile(&compiler, pass);
+					state->compile_success = false;
+					LogCompileErrors(renderPassNames[pass], passEditor.diagnostics, passEditor.log);
 				}
 				else
 				{
-					errorMarkers.clear();
-					printf("Compile Success!\n");
-
-					iTimeLocation = glGetUniformLocation(program, "iTime");
-					iResolutionLocation = glGetUniformLocation(program, "iResolution");;
-					iTimeDeltaLocation = glGetUniformLocation(program, "iTimeDelta");;
-					iFrameLocation = glGetUniformLocation(program, "iFrame");;
-					//iChannelTimeLocation = glGetUniformLocation(program, "iChannelTime");
-					//iChannelResolutionLocation = glGetUniformLocation(program, "iChannelResolution");;
-					iMouseLocation = glGetUniformLocation(program, "iMouse");;
-					//iDateLocation = glGetUniformLocation(program, "iDate");;
-					//iSampleRateLocation = glGetUniformLocation(program, "iSampleRate");
+					RequestShaderCompile(&compiler, pass, editorString, key);
 				}
-				state->want_save = false;
+			}
+			state->want_save = false;
+		}
+
+		// check the code once typing pauses, so errors show up without saving
+		double validateNow = glfwGetTime();
+		state->wake_time = 0.0;
+		for (int pass = 0; pass < RenderPass_Count; pass++)
+		{
+			PassEditor& passEditor = passEditors[pass];
+			if (passEditor.validate_time == 0.0 || !renderer.passes[pass].enabled)
+				continue;
+			if (validateNow < passEditor.validate_time)
+			{
+				if (state->wake_time == 0.0 || passEditor.validate_time < state->wake_time)
+					state->wake_time = passEditor.validate_time;
+				continue;
+			}
+
+			passEditor.validate_time = 0.0;
+			passEditor.editor.GetText(passEditor.source);
+			uint64_t key = HashShaderSource(&programCache, passEditor.source);
+			passEditor.validate_key = key;
+			if (FindCachedProgram(&programCache, key))
+				SetPassLog(&passEditor, key, false, std::string());
+			else if (key != passEditor.log_key)
+				RequestShaderValidation(&compiler, pass, passEditor.source, key);
+		}
+		ShaderValidation validation;
+		while (PollShaderValidation(&compiler, &validation))
+		{
+			PassEditor& passEditor = passEditors[validation.pass];
+			if (validation.key == passEditor.validate_key)
+				SetPassLog(&passEditor, validation.key, !validation.success, validation.log);
+		}
+
+		// The previous program keeps running until a new one links successfully
+		CompiledProgram compiled;
+		std::vector<ShaderDiagnostic> diagnostics;
+		while (PollShaderCompile(&compiler, &compiled))
+		{
+			AddProfileTime(&profiler, ProfileZone_Compile, compiled.build_ms);
+			PassEditor& passEditor = passEditors[compiled.pass];
+			const char* passName = renderPassNames[compiled.pass];
+			state->compile_success = compiled.success;
+			// validation may already have reported on text typed after this save
+			bool current = compiled.key == passEditor.validate_key;
+			if (compiled.compile_failed)
+			{
+				ParseShaderLog(compiled.log.data(), compiled.log.size(), &diagnostics);
+				LogCompileErrors(passName, diagnostics, compiled.log);
+				if (current)
+					SetPassLog(&passEditor, compiled.key, true, compiled.log);
+			}
+			else if (!compiled.success)
+			{
+				consoleLogger.AddLog("%s: Shader Link Failed %s", passName, compiled.log.c_str());
+				printf("Shader Link Failed! : %s\n", compiled.log.c_str());
 			}
 
-			glBindFramebuffer(GL_FRAMEBUFFER, fbo);
-			static int updateCount = 0;
-			if (state->want_update)
+			if (compiled.success)
 			{
-				updateCount++;
-				glDeleteTextures(1, &colorAttachMent);
-				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
-				glGenTextures(1, &colorAttachMent);
-				glBindTexture(GL_TEXTURE_2D, colorAttachMent);
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, state->fb_width, state->fb_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-				glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorAttachMent, 0);
-				state->want_update = false;
+				if (current)
+					SetPassLog(&passEditor, compiled.key, false, std::string());
+				// another pass with the same source may have linked it first and already be using it
+				unsigned int program = FindCachedProgram(&programCache, compiled.key);
+				if (program)
+					DeleteCompiledProgram(&compiled);
+				else
+					AddCachedProgram(&programCache, compiled.key, program = compiled.program);
+				SetPassKey(&programCache, &passEditor, compiled.key);
+				SetPassProgram(&renderer, compiled.pass, program, compiled.inputs_used);
+				printf(compiled.from_disk_cache ? "%s: Loaded From Cache!\n" : "%s: Compile Success!\n", passName);
 			}
+			else
+			{
+				DeleteCompiledProgram(&compiled);
+			}
+			compiled = CompiledProgram();
+		}
 
-			glUniform1f(iTimeLocation, iTime);
-			glUniform3f(iResolutionLocation, state->fb_width, state->fb_height, 0.0f);
-			glUniform1f(iTimeDeltaLocation, iTimeDelta);
-			glUniform1i(iFrameLocation, iFrame);
-			double mouse_x = 0, mouse_y = 0;
-			float left_click = 0, right_click = 0;
-			left_click = (float)glfwGetMouseButton(state->window, GLFW_MOUSE_BUTTON_LEFT);
-			right_click = (float)glfwGetMouseButton(state->window, GLFW_MOUSE_BUTTON_RIGHT);
-			glfwGetCursorPos(state->window, &mouse_x, &mouse_y);
-			glUniform4f(iMouseLocation, (float)mouse_x, (float)mouse_y, left_click, right_click);
-			glUseProgram(program);
-			glBindBuffer(GL_ARRAY_BUFFER, vbo);
-			glViewport(0, 0, state->fb_width, state->fb_height);
-			glDrawArrays(GL_QUADS, 0, 4);
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		UpdateTextureLoader(&textureLoader);
+		std::string textureError;
+		while (PollTextureError(&textureLoader, &textureError))
+			consoleLogger.AddLog("Failed to load texture %s\n", textureError.c_str());
+
+		static int updateCount = 0;
+		if (state->want_update)
+		{
+			updateCount++;
+			int renderWidth = 0, renderHeight = 0;
+			GetRenderSize(&dynamicResolution, state->fb_width, state->fb_height, &renderWidth, &renderHeight);
+			ResizeRenderTarget(&renderer, renderWidth, renderHeight);
+			state->want_update = false;
+		}
+
+		double mouse_x = 0, mouse_y = 0;
+		glfwGetCursorPos(state->window, &mouse_x, &mouse_y);
+		inputs.mouse[0] = (float)mouse_x;
+		inputs.mouse[1] = (float)mouse_y;
+		inputs.mouse[2] = (float)glfwGetMouseButton(state->window, GLFW_MOUSE_BUTTON_LEFT);
+		inputs.mouse[3] = (float)glfwGetMouseButton(state->window, GLFW_MOUSE_BUTTON_RIGHT);
+		if (viewVisible)
+		{
+			BeginProfileZone(&profiler, ProfileZone_ShaderPass);
+			BeginGpuTimer(&shaderTimer);
+			bool rendered = RenderShader(&renderer, inputs);
+			EndGpuTimer(&shaderTimer, rendered);
+			EndProfileZone(&profiler, ProfileZone_ShaderPass);
+		}
+		float gpuMilliseconds = 0.0f;
+		while (PollGpuTimer(&shaderTimer, &gpuMilliseconds))
+		{
+			AddGpuProfileTime(&profiler, ProfileZone_ShaderPass, gpuMilliseconds);
+			if (UpdateDynamicResolution(&dynamicResolution, gpuMilliseconds))
+				state->want_update = true;
+		}
+		while (PollGpuTimer(&uiTimer, &gpuMilliseconds))
+			AddGpuProfileTime(&profiler, ProfileZone_UIDraw, gpuMilliseconds);
+
+		// otherwise the loop sleeps until input, a finished compile or a decoded texture wakes it
+		state->animating = (viewVisible && IsRendererAnimating(&renderer)) || HasTextureUploads(&textureLoader);
 
 #ifdef _DEBUG
-			ImGui::Begin("State", 0, ImGuiWindowFlags_AlwaysAutoResize);
-			ImGui::Text("Region Avail %f, %f", avail.x, avail.y);
-			ImGui::Text("Texture Size %d, %d", state->fb_width, state->fb_height);
+		ImGui::Begin("State", 0, ImGuiWindowFlags_AlwaysAutoResize);
+		ImGui::Text("Region Avail %f, %f", avail.x, avail.y);
+		ImGui::Text("Texture Size %d, %d", state->fb_width, state->fb_height);
 
-			ImGui::Text("Update Count %d", updateCount);
-			ImGui::End();
+		ImGui::Text("Update Count %d", updateCount);
+
+		// highlighting of the Image code repeated 20 times, ~3000 lines for a typical shader
+		static float nativeColorizeMs = 0.0f, regexColorizeMs = 0.0f;
+		if (ImGui::Button("Benchmark Highlighting"))
+		{
+			std::string code = passEditors[RenderPass_Image].editor.GetText();
+			std::string benchmarkCode;
+			for (int i = 0; i < 20; i++)
+				benchmarkCode += code;
+			TextEditor::BenchmarkGLSLColorize(benchmarkCode, nativeColorizeMs, regexColorizeMs);
+		}
+		ImGui::Text("Native %.2f ms, Regex %.2f ms", nativeColorizeMs, regexColorizeMs);
+
+		// 500 errors in each driver format
+		static float logParseMs = 0.0f, logRegexMs = 0.0f;
+		if (ImGui::Button("Benchmark Log Parsing"))
+			BenchmarkShaderLogParse(500, &logParseMs, &logRegexMs);
+		ImGui::Text("Parser %.2f ms, Regex %.2f ms", logParseMs, logRegexMs);
+		ImGui::End();
 #endif // _DEBUG
 
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-			glfwSwapBuffers(state->window);
+		if (showProfiler)
+			DrawProfiler(&profiler, &showProfiler);
 
-		}
+		BeginProfileZone(&profiler, ProfileZone_UIDraw);
+		BeginGpuTimer(&uiTimer);
+		ImGui::Render();
+		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		EndGpuTimer(&uiTimer);
+		EndProfileZone(&profiler, ProfileZone_UIDraw);
+
+		BeginProfileZone(&profiler, ProfileZone_SwapWait);
+		glfwSwapBuffers(state->window);
+		EndProfileZone(&profiler, ProfileZone_SwapWait);
+
+		EndProfileZone(&profiler, ProfileZone_Frame);
+		EndProfileFrame(&profiler);
 	}
 
+	ShutdownShaderCompiler(&compiler);
+	ShutdownProgramCache(&programCache);
+	ShutdownTextureLoader(&textureLoader);
+	ShutdownGpuTimer(&shaderTimer);
+	ShutdownGpuTimer(&uiTimer);
+	ShutdownRenderer(&renderer);
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
@@ -0,0 +1,651 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Generated by GlslWords.py, edit the word lists there and run it again.
+// GLSL 4.60 keywords and built-ins as a perfect hash, so the colorizer can classify an
+// identifier in place without copying it into a std::string first.
+
+enum GlslWordKind : uint8_t
+{
+	GlslWord_None,
+	GlslWord_Keyword,
+	GlslWord_Function,
+	GlslWord_Variable,
+};
+
+struct GlslWord
+{
+	const char* text;
+	uint8_t length;
+	GlslWordKind kind;
+};
+
+constexpr GlslWord glslWords[] = {
+	{ "const", 5, GlslWord_Keyword },
+	{ "uniform", 7, GlslWord_Keyword },
+	{ "buffer", 6, GlslWord_Keyword },
+	{ "shared", 6, GlslWord_Keyword },
+	{ "attribute", 9, GlslWord_Keyword },
+	{ "varying", 7, GlslWord_Keyword },
+	{ "coherent", 8, GlslWord_Keyword },
+	{ "volatile", 8, GlslWord_Keyword },
+	{ "restrict", 8, GlslWord_Keyword },
+	{ "readonly", 8, GlslWord_Keyword },
+	{ "writeonly", 9, GlslWord_Keyword },
+	{ "atomic_uint", 11, GlslWord_Keyword },
+	{ "layout", 6, GlslWord_Keyword },
+	{ "centroid", 8, GlslWord_Keyword },
+	{ "flat", 4, GlslWord_Keyword },
+	{ "smooth", 6, GlslWord_Keyword },
+	{ "noperspective", 13, GlslWord_Keyword },
+	{ "patch", 5, GlslWord_Keyword },
+	{ "sample", 6, GlslWord_Keyword },
+	{ "invariant", 9, GlslWord_Keyword },
+	{ "precise", 7, GlslWord_Keyword },
+	{ "break", 5, GlslWord_Keyword },
+	{ "continue", 8, GlslWord_Keyword },
+	{ "do", 2, GlslWord_Keyword },
+	{ "for", 3, GlslWord_Keyword },
+	{ "while", 5, GlslWord_Keyword },
+	{ "switch", 6, GlslWord_Keyword },
+	{ "case", 4, GlslWord_Keyword },
+	{ "default", 7, GlslWord_Keyword },
+	{ "if", 2, GlslWord_Keyword },
+	{ "else", 4, GlslWord_Keyword },
+	{ "subroutine", 10, GlslWord_Keyword },
+	{ "in", 2, GlslWord_Keyword },
+	{ "out", 3, GlslWord_Keyword },
+	{ "inout", 5, GlslWord_Keyword },
+	{ "int", 3, GlslWord_Keyword },
+	{ "void", 4, GlslWord_Keyword },
+	{ "bool", 4, GlslWord_Keyword },
+	{ "true", 4, GlslWord_Keyword },
+	{ "false", 5, GlslWord_Keyword },
+	{ "float", 5, GlslWord_Keyword },
+	{ "double", 6, GlslWord_Keyword },
+	{ "discard", 7, GlslWord_Keyword },
+	{ "return", 6, GlslWord_Keyword },
+	{ "vec2", 4, GlslWord_Keyword },
+	{ "vec3", 4, GlslWord_Keyword },
+	{ "vec4", 4, GlslWord_Keyword },
+	{ "ivec2", 5, GlslWord_Keyword },
+	{ "ivec3", 5, GlslWord_Keyword },
+	{ "ivec4", 5, GlslWord_Keyword },
+	{ "bvec2", 5, GlslWord_Keyword },
+	{ "bvec3", 5, GlslWord_Keyword },
+	{ "bvec4", 5, GlslWord_Keyword },
+	{ "uint", 4, GlslWord_Keyword },
+	{ "uvec2", 5, GlslWord_Keyword },
+	{ "uvec3", 5, GlslWord_Keyword },
+	{ "uvec4", 5, GlslWord_Keyword },
+	{ "dvec2", 5, GlslWord_Keyword },
+	{ "dvec3", 5, GlslWord_Keyword },
+	{ "dvec4", 5, GlslWord_Keyword },
+	{ "mat2", 4, GlslWord_Keyword },
+	{ "mat3", 4, GlslWord_Keyword },
+	{ "mat4", 4, GlslWord_Keyword },
+	{ "mat2x2", 6, GlslWord_Keyword },
+	{ "mat2x3", 6, GlslWord_Keyword },
+	{ "mat2x4", 6, GlslWord_Keyword },
+	{ "mat3x2", 6, GlslWord_Keyword },
+	{ "mat3x3", 6, GlslWord_Keyword },
+	{ "mat3x4", 6, GlslWord_Keyword },
+	{ "mat4x2", 6, GlslWord_Keyword },
+	{ "mat4x3", 6, GlslWord_Keyword },
+	{ "mat4x4", 6, GlslWord_Keyword },
+	{ "dmat2", 5, GlslWord_Keyword },
+	{ "dmat3", 5, GlslWord_Keyword },
+	{ "dmat4", 5, GlslWord_Keyword },
+	{ "dmat2x2", 7, GlslWord_Keyword },
+	{ "dmat2x3", 7, GlslWord_Keyword },
+	{ "dmat2x4", 7, GlslWord_Keyword },
+	{ "dmat3x2", 7, GlslWord_Keyword },
+	{ "dmat3x3", 7, GlslWord_Keyword },
+	{ "dmat3x4", 7, GlslWord_Keyword },
+	{ "dmat4x2", 7, GlslWord_Keyword },
+	{ "dmat4x3", 7, GlslWord_Keyword },
+	{ "dmat4x4", 7, GlslWord_Keyword },
+	{ "lowp", 4, GlslWord_Keyword },
+	{ "mediump", 7, GlslWord_Keyword },
+	{ "highp", 5, GlslWord_Keyword },
+	{ "precision", 9, GlslWord_Keyword },
+	{ "sampler1D", 9, GlslWord_Keyword },
+	{ "sampler1DShadow", 15, GlslWord_Keyword },
+	{ "sampler1DArray", 14, GlslWord_Keyword },
+	{ "sampler1DArrayShadow", 20, GlslWord_Keyword },
+	{ "isampler1D", 10, GlslWord_Keyword },
+	{ "isampler1DArray", 15, GlslWord_Keyword },
+	{ "usampler1D", 10, GlslWord_Keyword },
+	{ "usampler1DArray", 15, GlslWord_Keyword },
+	{ "sampler2D", 9, GlslWord_Keyword },
+	{ "sampler2DShadow", 15, GlslWord_Keyword },
+	{ "sampler2DArray", 14, GlslWord_Keyword },
+	{ "sampler2DArrayShadow", 20, GlslWord_Keyword },
+	{ "isampler2D", 10, GlslWord_Keyword },
+	{ "isampler2DArray", 15, GlslWord_Keyword },
+	{ "usampler2D", 10, GlslWord_Keyword },
+	{ "usampler2DArray", 15, GlslWord_Keyword },
+	{ "sampler2DRect", 13, GlslWord_Keyword },
+	{ "sampler2DRectShadow", 19, GlslWord_Keyword },
+	{ "isampler2DRect", 14, GlslWord_Keyword },
+	{ "usampler2DRect", 14, GlslWord_Keyword },
+	{ "sampler2DMS", 11, GlslWord_Keyword },
+	{ "isampler2DMS", 12, GlslWord_Keyword },
+	{ "usampler2DMS", 12, GlslWord_Keyword },
+	{ "sampler2DMSArray", 16, GlslWord_Keyword },
+	{ "isampler2DMSArray", 17, GlslWord_Keyword },
+	{ "usampler2DMSArray", 17, GlslWord_Keyword },
+	{ "sampler3D", 9, GlslWord_Keyword },
+	{ "isampler3D", 10, GlslWord_Keyword },
+	{ "usampler3D", 10, GlslWord_Keyword },
+	{ "samplerCube", 11, GlslWord_Keyword },
+	{ "samplerCubeShadow", 17, GlslWord_Keyword },
+	{ "isamplerCube", 12, GlslWord_Keyword },
+	{ "usamplerCube", 12, GlslWord_Keyword },
+	{ "samplerCubeArray", 16, GlslWord_Keyword },
+	{ "samplerCubeArrayShadow", 22, GlslWord_Keyword },
+	{ "isamplerCubeArray", 17, GlslWord_Keyword },
+	{ "usamplerCubeArray", 17, GlslWord_Keyword },
+	{ "samplerBuffer", 13, GlslWord_Keyword },
+	{ "isamplerBuffer", 14, GlslWord_Keyword },
+	{ "usamplerBuffer", 14, GlslWord_Keyword },
+	{ "image1D", 7, GlslWord_Keyword },
+	{ "iimage1D", 8, GlslWord_Keyword },
+	{ "uimage1D", 8, GlslWord_Keyword },
+	{ "image1DArray", 12, GlslWord_Keyword },
+	{ "iimage1DArray", 13, GlslWord_Keyword },
+	{ "uimage1DArray", 13, GlslWord_Keyword },
+	{ "image2D", 7, GlslWord_Keyword },
+	{ "iimage2D", 8, GlslWord_Keyword },
+	{ "uimage2D", 8, GlslWord_Keyword },
+	{ "image2DArray", 12, GlslWord_Keyword },
+	{ "iimage2DArray", 13, GlslWord_Keyword },
+	{ "uimage2DArray", 13, GlslWord_Keyword },
+	{ "image2DRect", 11, GlslWord_Keyword },
+	{ "iimage2DRect", 12, GlslWord_Keyword },
+	{ "uimage2DRect", 12, GlslWord_Keyword },
+	{ "image2DMS", 9, GlslWord_Keyword },
+	{ "iimage2DMS", 10, GlslWord_Keyword },
+	{ "uimage2DMS", 10, GlslWord_Keyword },
+	{ "image2DMSArray", 14, GlslWord_Keyword },
+	{ "iimage2DMSArray", 15, GlslWord_Keyword },
+	{ "uimage2DMSArray", 15, GlslWord_Keyword },
+	{ "image3D", 7, GlslWord_Keyword },
+	{ "iimage3D", 8, GlslWord_Keyword },
+	{ "uimage3D", 8, GlslWord_Keyword },
+	{ "imageCube", 9, GlslWord_Keyword },
+	{ "iimageCube", 10, GlslWord_Keyword },
+	{ "uimageCube", 10, GlslWord_Keyword },
+	{ "imageCubeArray", 14, GlslWord_Keyword },
+	{ "iimageCubeArray", 15, GlslWord_Keyword },
+	{ "uimageCubeArray", 15, GlslWord_Keyword },
+	{ "imageBuffer", 11, GlslWord_Keyword },
+	{ "iimageBuffer", 12, GlslWord_Keyword },
+	{ "uimageBuffer", 12, GlslWord_Keyword },
+	{ "struct", 6, GlslWord_Keyword },
+	{ "common", 6, GlslWord_Keyword },
+	{ "partition", 9, GlslWord_Keyword },
+	{ "active", 6, GlslWord_Keyword },
+	{ "asm", 3, GlslWord_Keyword },
+	{ "class", 5, GlslWord_Keyword },
+	{ "union", 5, GlslWord_Keyword },
+	{ "enum", 4, GlslWord_Keyword },
+	{ "typedef", 7, GlslWord_Keyword },
+	{ "template", 8, GlslWord_Keyword },
+	{ "this", 4, GlslWord_Keyword },
+	{ "resource", 8, GlslWord_Keyword },
+	{ "goto", 4, GlslWord_Keyword },
+	{ "inline", 6, GlslWord_Keyword },
+	{ "noinline", 8, GlslWord_Keyword },
+	{ "public", 6, GlslWord_Keyword },
+	{ "static", 6, GlslWord_Keyword },
+	{ "extern", 6, GlslWord_Keyword },
+	{ "external", 8, GlslWord_Keyword },
+	{ "interface", 9, GlslWord_Keyword },
+	{ "long", 4, GlslWord_Keyword },
+	{ "short", 5, GlslWord_Keyword },
+	{ "half", 4, GlslWord_Keyword },
+	{ "fixed", 5, GlslWord_Keyword },
+	{ "unsigned", 8, GlslWord_Keyword },
+	{ "superp", 6, GlslWord_Keyword },
+	{ "input", 5, GlslWord_Keyword },
+	{ "output", 6, GlslWord_Keyword },
+	{ "hvec2", 5, GlslWord_Keyword },
+	{ "hvec3", 5, GlslWord_Keyword },
+	{ "hvec4", 5, GlslWord_Keyword },
+	{ "fvec2", 5, GlslWord_Keyword },
+	{ "fvec3", 5, GlslWord_Keyword },
+	{ "fvec4", 5, GlslWord_Keyword },
+	{ "filter", 6, GlslWord_Keyword },
+	{ "sizeof", 6, GlslWord_Keyword },
+	{ "cast", 4, GlslWord_Keyword },
+	{ "namespace", 9, GlslWord_Keyword },
+	{ "using", 5, GlslWord_Keyword },
+	{ "sampler3DRect", 13, GlslWord_Keyword },
+	{ "radians", 7, GlslWord_Function },
+	{ "degrees", 7, GlslWord_Function },
+	{ "sin", 3, GlslWord_Function },
+	{ "cos", 3, GlslWord_Function },
+	{ "tan", 3, GlslWord_Function },
+	{ "asin", 4, GlslWord_Function },
+	{ "acos", 4, GlslWord_Function },
+	{ "atan", 4, GlslWord_Function },
+	{ "sinh", 4, GlslWord_Function },
+	{ "cosh", 4, GlslWord_Function },
+	{ "tanh", 4, GlslWord_Function },
+	{ "asinh", 5, GlslWord_Function },
+	{ "acosh", 5, GlslWord_Function },
+	{ "atanh", 5, GlslWord_Function },
+	{ "pow", 3, GlslWord_Function },
+	{ "exp", 3, GlslWord_Function },
+	{ "log", 3, GlslWord_Function },
+	{ "exp2", 4, GlslWord_Function },
+	{ "log2", 4, GlslWord_Function },
+	{ "sqrt", 4, GlslWord_Function },
+	{ "inversesqrt", 11, GlslWord_Function },
+	{ "abs", 3, GlslWord_Function },
+	{ "sign", 4, GlslWord_Function },
+	{ "floor", 5, GlslWord_Function },
+	{ "trunc", 5, GlslWord_Function },
+	{ "round", 5, GlslWord_Function },
+	{ "roundEven", 9, GlslWord_Function },
+	{ "ceil", 4, GlslWord_Function },
+	{ "fract", 5, GlslWord_Function },
+	{ "mod", 3, GlslWord_Function },
+	{ "modf", 4, GlslWord_Function },
+	{ "min", 3, GlslWord_Function },
+	{ "max", 3, GlslWord_Function },
+	{ "clamp", 5, GlslWord_Function },
+	{ "mix", 3, GlslWord_Function },
+	{ "step", 4, GlslWord_Function },
+	{ "smoothstep", 10, GlslWord_Function },
+	{ "isnan", 5, GlslWord_Function },
+	{ "isinf", 5, GlslWord_Function },
+	{ "floatBitsToInt", 14, GlslWord_Function },
+	{ "floatBitsToUint", 15, GlslWord_Function },
+	{ "intBitsToFloat", 14, GlslWord_Function },
+	{ "uintBitsToFloat", 15, GlslWord_Function },
+	{ "fma", 3, GlslWord_Function },
+	{ "frexp", 5, GlslWord_Function },
+	{ "ldexp", 5, GlslWord_Function },
+	{ "packUnorm2x16", 13, GlslWord_Function },
+	{ "packSnorm2x16", 13, GlslWord_Function },
+	{ "packUnorm4x8", 12, GlslWord_Function },
+	{ "packSnorm4x8", 12, GlslWord_Function },
+	{ "unpackUnorm2x16", 15, GlslWord_Function },
+	{ "unpackSnorm2x16", 15, GlslWord_Function },
+	{ "unpackUnorm4x8", 14, GlslWord_Function },
+	{ "unpackSnorm4x8", 14, GlslWord_Function },
+	{ "packHalf2x16", 12, GlslWord_Function },
+	{ "unpackHalf2x16", 14, GlslWord_Function },
+	{ "packDouble2x32", 14, GlslWord_Function },
+	{ "unpackDouble2x32", 16, GlslWord_Function },
+	{ "length", 6, GlslWord_Function },
+	{ "distance", 8, GlslWord_Function },
+	{ "dot", 3, GlslWord_Function },
+	{ "cross", 5, GlslWord_Function },
+	{ "normalize", 9, GlslWord_Function },
+	{ "faceforward", 11, GlslWord_Function },
+	{ "reflect", 7, GlslWord_Function },
+	{ "refract", 7, GlslWord_Function },
+	{ "matrixCompMult", 14, GlslWord_Function },
+	{ "outerProduct", 12, GlslWord_Function },
+	{ "transpose", 9, GlslWord_Function },
+	{ "determinant", 11, GlslWord_Function },
+	{ "inverse", 7, GlslWord_Function },
+	{ "lessThan", 8, GlslWord_Function },
+	{ "lessThanEqual", 13, GlslWord_Function },
+	{ "greaterThan", 11, GlslWord_Function },
+	{ "greaterThanEqual", 16, GlslWord_Function },
+	{ "equal", 5, GlslWord_Function },
+	{ "notEqual", 8, GlslWord_Function },
+	{ "any", 3, GlslWord_Function },
+	{ "all", 3, GlslWord_Function },
+	{ "not", 3, GlslWord_Function },
+	{ "uaddCarry", 9, GlslWord_Function },
+	{ "usubBorrow", 10, GlslWord_Function },
+	{ "umulExtended", 12, GlslWord_Function },
+	{ "imulExtended", 12, GlslWord_Function },
+	{ "bitfieldExtract", 15, GlslWord_Function },
+	{ "bitfieldInsert", 14, GlslWord_Function },
+	{ "bitfieldReverse", 15, GlslWord_Function },
+	{ "bitCount", 8, GlslWord_Function },
+	{ "findLSB", 7, GlslWord_Function },
+	{ "findMSB", 7, GlslWord_Function },
+	{ "textureSize", 11, GlslWord_Function },
+	{ "textureQueryLod", 15, GlslWord_Function },
+	{ "textureQueryLevels", 18, GlslWord_Function },
+	{ "textureSamples", 14, GlslWord_Function },
+	{ "texture", 7, GlslWord_Function },
+	{ "textureProj", 11, GlslWord_Function },
+	{ "textureLod", 10, GlslWord_Function },
+	{ "textureOffset", 13, GlslWord_Function },
+	{ "texelFetch", 10, GlslWord_Function },
+	{ "texelFetchOffset", 16, GlslWord_Function },
+	{ "textureProjOffset", 17, GlslWord_Function },
+	{ "textureLodOffset", 16, GlslWord_Function },
+	{ "textureProjLod", 14, GlslWord_Function },
+	{ "textureProjLodOffset", 20, GlslWord_Function },
+	{ "textureGrad", 11, GlslWord_Function },
+	{ "textureGradOffset", 17, GlslWord_Function },
+	{ "textureProjGrad", 15, GlslWord_Function },
+	{ "textureProjGradOffset", 21, GlslWord_Function },
+	{ "textureGather", 13, GlslWord_Function },
+	{ "textureGatherOffset", 19, GlslWord_Function },
+	{ "textureGatherOffsets", 20, GlslWord_Function },
+	{ "atomicCounterIncrement", 22, GlslWord_Function },
+	{ "atomicCounterDecrement", 22, GlslWord_Function },
+	{ "atomicCounter", 13, GlslWord_Function },
+	{ "atomicCounterAdd", 16, GlslWord_Function },
+	{ "atomicCounterSubtract", 21, GlslWord_Function },
+	{ "atomicCounterMin", 16, GlslWord_Function },
+	{ "atomicCounterMax", 16, GlslWord_Function },
+	{ "atomicCounterAnd", 16, GlslWord_Function },
+	{ "atomicCounterOr", 15, GlslWord_Function },
+	{ "atomicCounterXor", 16, GlslWord_Function },
+	{ "atomicCounterExchange", 21, GlslWord_Function },
+	{ "atomicCounterCompSwap", 21, GlslWord_Function },
+	{ "atomicAdd", 9, GlslWord_Function },
+	{ "atomicMin", 9, GlslWord_Function },
+	{ "atomicMax", 9, GlslWord_Function },
+	{ "atomicAnd", 9, GlslWord_Function },
+	{ "atomicOr", 8, GlslWord_Function },
+	{ "atomicXor", 9, GlslWord_Function },
+	{ "atomicExchange", 14, GlslWord_Function },
+	{ "atomicCompSwap", 14, GlslWord_Function },
+	{ "imageSize", 9, GlslWord_Function },
+	{ "imageSamples", 12, GlslWord_Function },
+	{ "imageLoad", 9, GlslWord_Function },
+	{ "imageStore", 10, GlslWord_Function },
+	{ "imageAtomicAdd", 14, GlslWord_Function },
+	{ "imageAtomicMin", 14, GlslWord_Function },
+	{ "imageAtomicMax", 14, GlslWord_Function },
+	{ "imageAtomicAnd", 14, GlslWord_Function },
+	{ "imageAtomicOr", 13, GlslWord_Function },
+	{ "imageAtomicXor", 14, GlslWord_Function },
+	{ "imageAtomicExchange", 19, GlslWord_Function },
+	{ "imageAtomicCompSwap", 19, GlslWord_Function },
+	{ "EmitStreamVertex", 16, GlslWord_Function },
+	{ "EndStreamPrimitive", 18, GlslWord_Function },
+	{ "EmitVertex", 10, GlslWord_Function },
+	{ "EndPrimitive", 12, GlslWord_Function },
+	{ "dFdx", 4, GlslWord_Function },
+	{ "dFdy", 4, GlslWord_Function },
+	{ "dFdxFine", 8, GlslWord_Function },
+	{ "dFdyFine", 8, GlslWord_Function },
+	{ "dFdxCoarse", 10, GlslWord_Function },
+	{ "dFdyCoarse", 10, GlslWord_Function },
+	{ "fwidth", 6, GlslWord_Function },
+	{ "fwidthFine", 10, GlslWord_Function },
+	{ "fwidthCoarse", 12, GlslWord_Function },
+	{ "interpolateAtCentroid", 21, GlslWord_Function },
+	{ "interpolateAtSample", 19, GlslWord_Function },
+	{ "interpolateAtOffset", 19, GlslWord_Function },
+	{ "noise1", 6, GlslWord_Function },
+	{ "noise2", 6, GlslWord_Function },
+	{ "noise3", 6, GlslWord_Function },
+	{ "noise4", 6, GlslWord_Function },
+	{ "barrier", 7, GlslWord_Function },
+	{ "memoryBarrier", 13, GlslWord_Function },
+	{ "memoryBarrierAtomicCounter", 26, GlslWord_Function },
+	{ "memoryBarrierBuffer", 19, GlslWord_Function },
+	{ "memoryBarrierShared", 19, GlslWord_Function },
+	{ "memoryBarrierImage", 18, GlslWord_Function },
+	{ "groupMemoryBarrier", 18, GlslWord_Function },
+	{ "anyInvocation", 13, GlslWord_Function },
+	{ "allInvocations", 14, GlslWord_Function },
+	{ "allInvocationsEqual", 19, GlslWord_Function },
+	{ "gl_VertexID", 11, GlslWord_Variable },
+	{ "gl_InstanceID", 13, GlslWord_Variable },
+	{ "gl_DrawID", 9, GlslWord_Variable },
+	{ "gl_BaseVertex", 13, GlslWord_Variable },
+	{ "gl_BaseInstance", 15, GlslWord_Variable },
+	{ "gl_PerVertex", 12, GlslWord_Variable },
+	{ "gl_Position", 11, GlslWord_Variable },
+	{ "gl_PointSize", 12, GlslWord_Variable },
+	{ "gl_ClipDistance", 15, GlslWord_Variable },
+	{ "gl_CullDistance", 15, GlslWord_Variable },
+	{ "gl_PatchVerticesIn", 18, GlslWord_Variable },
+	{ "gl_PrimitiveID", 14, GlslWord_Variable },
+	{ "gl_InvocationID", 15, GlslWord_Variable },
+	{ "gl_TessLevelOuter", 17, GlslWord_Variable },
+	{ "gl_TessLevelInner", 17, GlslWord_Variable },
+	{ "gl_TessCoord", 12, GlslWord_Variable },
+	{ "gl_in", 5, GlslWord_Variable },
+	{ "gl_out", 6, GlslWord_Variable },
+	{ "gl_PrimitiveIDIn", 16, GlslWord_Variable },
+	{ "gl_Layer", 8, GlslWord_Variable },
+	{ "gl_ViewportIndex", 16, GlslWord_Variable },
+	{ "gl_FragCoord", 12, GlslWord_Variable },
+	{ "gl_FrontFacing", 14, GlslWord_Variable },
+	{ "gl_PointCoord", 13, GlslWord_Variable },
+	{ "gl_SampleID", 11, GlslWord_Variable },
+	{ "gl_SamplePosition", 17, GlslWord_Variable },
+	{ "gl_SampleMaskIn", 15, GlslWord_Variable },
+	{ "gl_HelperInvocation", 19, GlslWord_Variable },
+	{ "gl_FragDepth", 12, GlslWord_Variable },
+	{ "gl_SampleMask", 13, GlslWord_Variable },
+	{ "gl_NumSamples", 13, GlslWord_Variable },
+	{ "gl_DepthRange", 13, GlslWord_Variable },
+	{ "gl_NumWorkGroups", 16, GlslWord_Variable },
+	{ "gl_WorkGroupSize", 16, GlslWord_Variable },
+	{ "gl_WorkGroupID", 14, GlslWord_Variable },
+	{ "gl_LocalInvocationID", 20, GlslWord_Variable },
+	{ "gl_GlobalInvocationID", 21, GlslWord_Variable },
+	{ "gl_LocalInvocationIndex", 23, GlslWord_Variable },
+	{ "gl_MaxVertexAttribs", 19, GlslWord_Variable },
+	{ "gl_MaxVertexUniformVectors", 26, GlslWord_Variable },
+	{ "gl_MaxVertexUniformComponents", 29, GlslWord_Variable },
+	{ "gl_MaxVertexOutputComponents", 28, GlslWord_Variable },
+	{ "gl_MaxVaryingComponents", 23, GlslWord_Variable },
+	{ "gl_MaxVaryingVectors", 20, GlslWord_Variable },
+	{ "gl_MaxVertexTextureImageUnits", 29, GlslWord_Variable },
+	{ "gl_MaxVertexImageUniforms", 25, GlslWord_Variable },
+	{ "gl_MaxVertexAtomicCounters", 26, GlslWord_Variable },
+	{ "gl_MaxVertexAtomicCounterBuffers", 32, GlslWord_Variable },
+	{ "gl_MaxTessPatchComponents", 25, GlslWord_Variable },
+	{ "gl_MaxPatchVertices", 19, GlslWord_Variable },
+	{ "gl_MaxTessGenLevel", 18, GlslWord_Variable },
+	{ "gl_MaxTessControlInputComponents", 32, GlslWord_Variable },
+	{ "gl_MaxTessControlOutputComponents", 33, GlslWord_Variable },
+	{ "gl_MaxTessControlTextureImageUnits", 34, GlslWord_Variable },
+	{ "gl_MaxTessControlUniformComponents", 34, GlslWord_Variable },
+	{ "gl_MaxTessControlTotalOutputComponents", 38, GlslWord_Variable },
+	{ "gl_MaxTessControlImageUniforms", 30, GlslWord_Variable },
+	{ "gl_MaxTessControlAtomicCounters", 31, GlslWord_Variable },
+	{ "gl_MaxTessControlAtomicCounterBuffers", 37, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationInputComponents", 35, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationOutputComponents", 36, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationTextureImageUnits", 37, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationUniformComponents", 37, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationImageUniforms", 33, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationAtomicCounters", 34, GlslWord_Variable },
+	{ "gl_MaxTessEvaluationAtomicCounterBuffers", 40, GlslWord_Variable },
+	{ "gl_MaxGeometryInputComponents", 29, GlslWord_Variable },
+	{ "gl_MaxGeometryOutputComponents", 30, GlslWord_Variable },
+	{ "gl_MaxGeometryImageUniforms", 27, GlslWord_Variable },
+	{ "gl_MaxGeometryTextureImageUnits", 31, GlslWord_Variable },
+	{ "gl_MaxGeometryOutputVertices", 28, GlslWord_Variable },
+	{ "gl_MaxGeometryTotalOutputComponents", 35, GlslWord_Variable },
+	{ "gl_MaxGeometryUniformComponents", 31, GlslWord_Variable },
+	{ "gl_MaxGeometryAtomicCounters", 28, GlslWord_Variable },
+	{ "gl_MaxGeometryAtomicCounterBuffers", 34, GlslWord_Variable },
+	{ "gl_MaxFragmentImageUniforms", 27, GlslWord_Variable },
+	{ "gl_MaxFragmentInputComponents", 29, GlslWord_Variable },
+	{ "gl_MaxFragmentUniformVectors", 28, GlslWord_Variable },
+	{ "gl_MaxFragmentUniformComponents", 31, GlslWord_Variable },
+	{ "gl_MaxFragmentAtomicCounters", 28, GlslWord_Variable },
+	{ "gl_MaxFragmentAtomicCounterBuffers", 34, GlslWord_Variable },
+	{ "gl_MaxDrawBuffers", 17, GlslWord_Variable },
+	{ "gl_MaxTextureImageUnits", 23, GlslWord_Variable },
+	{ "gl_MinProgramTexelOffset", 24, GlslWord_Variable },
+	{ "gl_MaxProgramTexelOffset", 24, GlslWord_Variable },
+	{ "gl_MaxImageUnits", 16, GlslWord_Variable },
+	{ "gl_MaxSamples", 13, GlslWord_Variable },
+	{ "gl_MaxImageSamples", 18, GlslWord_Variable },
+	{ "gl_MaxClipDistances", 19, GlslWord_Variable },
+	{ "gl_MaxCullDistances", 19, GlslWord_Variable },
+	{ "gl_MaxViewports", 15, GlslWord_Variable },
+	{ "gl_MaxComputeImageUniforms", 26, GlslWord_Variable },
+	{ "gl_MaxComputeWorkGroupCount", 27, GlslWord_Variable },
+	{ "gl_MaxComputeWorkGroupSize", 26, GlslWord_Variable },
+	{ "gl_MaxComputeUniformComponents", 30, GlslWord_Variable },
+	{ "gl_MaxComputeTextureImageUnits", 30, GlslWord_Variable },
+	{ "gl_MaxComputeAtomicCounters", 27, GlslWord_Variable },
+	{ "gl_MaxComputeAtomicCounterBuffers", 33, GlslWord_Variable },
+	{ "gl_MaxCombinedTextureImageUnits", 31, GlslWord_Variable },
+	{ "gl_MaxCombinedImageUniforms", 27, GlslWord_Variable },
+	{ "gl_MaxCombinedImageUnitsAndFragmentOutputs", 42, GlslWord_Variable },
+	{ "gl_MaxCombinedShaderOutputResources", 35, GlslWord_Variable },
+	{ "gl_MaxCombinedAtomicCounters", 28, GlslWord_Variable },
+	{ "gl_MaxCombinedAtomicCounterBuffers", 34, GlslWord_Variable },
+	{ "gl_MaxCombinedClipAndCullDistances", 34, GlslWord_Variable },
+	{ "gl_MaxAtomicCounterBindings", 27, GlslWord_Variable },
+	{ "gl_MaxAtomicCounterBufferSize", 29, GlslWord_Variable },
+	{ "gl_MaxTransformFeedbackBuffers", 30, GlslWord_Variable },
+	{ "gl_MaxTransformFeedbackInterleavedComponents", 44, GlslWord_Variable },
+};
+
+constexpr uint32_t glslWordSlotCount = 1024;
+constexpr uint32_t glslWordBucketCount = 256;
+constexpr size_t glslWordMaxLength = 44;
+
+// seed of the second hash for each bucket of the first one
+constexpr uint16_t glslWordDisplacements[glslWordBucketCount] = {
+	1, 3, 0, 1, 3, 2, 3, 2, 2, 1, 1, 1, 2, 0, 2, 1,
+	1, 1, 1, 1, 1, 1, 3, 1, 1, 4, 2, 1, 1, 1, 1, 1,
+	2, 3, 1, 0, 1, 4, 3, 1, 4, 2, 0, 1, 4, 1, 1, 2,
+	1, 0, 0, 1, 1, 2, 0, 2, 2, 1, 1, 1, 2, 4, 1, 2,
+	2, 3, 2, 0, 1, 0, 0, 1, 2, 1, 2, 3, 0, 1, 1, 1,
+	1, 2, 1, 1, 1, 1, 2, 3, 2, 2, 0, 1, 1, 1, 1, 1,
+	1, 1, 1, 2, 1, 2, 1, 3, 0, 1, 1, 1, 1, 1, 3, 1,
+	2, 1, 4, 0, 1, 2, 0, 1, 1, 2, 2, 6, 0, 1, 1, 1,
+	1, 1, 1, 1, 0, 3, 2, 2, 2, 1, 1, 2, 1, 2, 1, 0,
+	2, 0, 1, 2, 4, 0, 2, 1, 5, 0, 2, 2, 1, 3, 4, 4,
+	1, 1, 0, 2, 2, 1, 2, 2, 1, 1, 6, 3, 0, 0, 0, 1,
+	0, 2, 2, 1, 0, 1, 3, 1, 1, 1, 1, 3, 2, 1, 2, 1,
+	1, 2, 2, 2, 1, 2, 2, 4, 0, 2, 1, 1, 1, 0, 1, 5,
+	1, 2, 2, 2, 2, 4, 4, 2, 1, 6, 1, 1, 0, 1, 5, 1,
+	3, 4, 2, 3, 2, 1, 5, 1, 4, 7, 1, 3, 3, 1, 1, 2,
+	3, 0, 1, 1, 3, 1, 0, 2, 1, 1, 0, 2, 0, 2, 1, 1,
+};
+
+// index into glslWords, 0xffff for an empty slot
+constexpr uint16_t glslWordSlots[glslWordSlotCount] = {
+	0xffff, 0x01d0, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x01b2, 0x0148, 0xffff, 0x0182,
+	0x0001, 0x01bd, 0xffff, 0xffff, 0x001a, 0xffff, 0x00e8, 0xffff, 0xffff, 0xffff, 0x0120, 0xffff,
+	0xffff, 0x00c7, 0x01d7, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x00ab, 0xffff, 0xffff, 0x0101,
+	0x01be, 0x0031, 0x0111, 0x00d9, 0x004a, 0x00f5, 0x0066, 0xffff, 0x01b6, 0x00a7, 0x0053, 0xffff,
+	0x0139, 0x0014, 0x0000, 0xffff, 0x0135, 0x00b9, 0xffff, 0xffff, 0x0086, 0x0144, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x006e, 0x00df, 0x00b3, 0xffff, 0xffff, 0x018e, 0x017b,
+	0x0065, 0x00b6, 0x01df, 0x0158, 0xffff, 0x014b, 0xffff, 0xffff, 0x004e, 0xffff, 0x000b, 0x0169,
+	0xffff, 0xffff, 0x01b5, 0x005e, 0x0124, 0xffff, 0xffff, 0x011d, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x0138, 0x0025, 0x00e0, 0xffff, 0x01c9, 0x013d, 0x0051, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x0133, 0xffff, 0x0003, 0xffff, 0x015b, 0x00ae, 0xffff, 0xffff, 0xffff, 0x0108, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0x01af, 0xffff, 0xffff, 0xffff, 0xffff, 0x001d, 0x0163, 0x01a7,
+	0xffff, 0xffff, 0x01c3, 0xffff, 0xffff, 0x00fd, 0xffff, 0x008d, 0x0078, 0x00d2, 0xffff, 0xffff,
+	0x002d, 0xffff, 0x0018, 0xffff, 0xffff, 0xffff, 0xffff, 0x00b4, 0x00e6, 0x0002, 0x00eb, 0xffff,
+	0xffff, 0x0112, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x00d8, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0166, 0xffff, 0xffff, 0x016f, 0x004c, 0xffff, 0x003a,
+	0xffff, 0x0012, 0xffff, 0xffff, 0x00ac, 0x0075, 0x0061, 0xffff, 0xffff, 0xffff, 0x01c4, 0xffff,
+	0xffff, 0x01b7, 0x000f, 0x0175, 0x003c, 0x0096, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0x0104, 0xffff, 0x01aa, 0x00a0, 0x016d, 0x017d, 0x014c, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0x0063, 0xffff, 0x00b8, 0xffff, 0xffff, 0x01d6, 0x0129, 0xffff,
+	0xffff, 0x0168, 0x0197, 0x0052, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x01ae,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x00ff, 0x016c, 0x010f, 0xffff, 0x01cf, 0x0095,
+	0xffff, 0x0100, 0xffff, 0xffff, 0x00ce, 0xffff, 0x0105, 0x0062, 0xffff, 0x00b0, 0x016b, 0x007f,
+	0x00ba, 0xffff, 0xffff, 0x0089, 0xffff, 0x0090, 0x0116, 0x0107, 0x0088, 0x0099, 0xffff, 0xffff,
+	0xffff, 0x0196, 0xffff, 0xffff, 0x019a, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x0030, 0x00bb, 0x0073, 0x001e, 0xffff, 0xffff, 0x00a1, 0xffff, 0xffff, 0x006b, 0xffff, 0xffff,
+	0xffff, 0xffff, 0x01ac, 0x00bc, 0x00e3, 0x0033, 0xffff, 0xffff, 0x0199, 0xffff, 0xffff, 0x00cc,
+	0xffff, 0xffff, 0xffff, 0x000a, 0xffff, 0xffff, 0x00f1, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0x0106, 0x0027, 0xffff, 0xffff, 0x0127, 0x0043, 0xffff, 0x01a3, 0xffff, 0x00b2, 0x005f,
+	0xffff, 0xffff, 0x00a3, 0xffff, 0xffff, 0xffff, 0x018a, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x017a, 0x0079, 0xffff, 0x00ef, 0x005b, 0x0056, 0xffff, 0xffff, 0xffff, 0xffff, 0x01a4, 0xffff,
+	0xffff, 0xffff, 0x005a, 0xffff, 0x0157, 0x0114, 0xffff, 0xffff, 0xffff, 0x00ee, 0xffff, 0xffff,
+	0xffff, 0x00c1, 0xffff, 0xffff, 0x012c, 0x0154, 0xffff, 0x00f4, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x0115, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x01a1, 0xffff, 0xffff, 0xffff, 0x00b7, 0xffff,
+	0xffff, 0xffff, 0x00aa, 0x00fb, 0x0068, 0x00bf, 0xffff, 0x01d1, 0x00e2, 0xffff, 0xffff, 0x0179,
+	0xffff, 0xffff, 0x0048, 0xffff, 0xffff, 0x01cb, 0x003e, 0xffff, 0xffff, 0xffff, 0x015a, 0xffff,
+	0x0190, 0x00f3, 0x002a, 0x01d9, 0xffff, 0xffff, 0x0125, 0x007e, 0x011a, 0xffff, 0x00cb, 0x0036,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0159, 0xffff, 0x0165, 0xffff, 0xffff, 0x0087, 0xffff,
+	0x008e, 0x00ca, 0xffff, 0x0150, 0xffff, 0xffff, 0x0186, 0x019e, 0x013f, 0x012e, 0xffff, 0x0041,
+	0xffff, 0xffff, 0xffff, 0xffff, 0x00a6, 0xffff, 0xffff, 0x012d, 0xffff, 0x01bc, 0x00b5, 0x00da,
+	0x0097, 0x0189, 0x00cf, 0x010e, 0x0064, 0xffff, 0x0126, 0x008a, 0x01cc, 0xffff, 0xffff, 0xffff,
+	0x01d3, 0x0152, 0xffff, 0x00f6, 0xffff, 0x0016, 0xffff, 0x01b9, 0x0021, 0xffff, 0x011b, 0x006d,
+	0xffff, 0xffff, 0xffff, 0xffff, 0x0057, 0xffff, 0xffff, 0x012f, 0xffff, 0x0147, 0xffff, 0x00d6,
+	0x0151, 0x0019, 0x019c, 0xffff, 0xffff, 0x0004, 0x0173, 0xffff, 0xffff, 0x004f, 0xffff, 0xffff,
+	0x010c, 0x00c9, 0x0010, 0xffff, 0x0103, 0xffff, 0xffff, 0x00f0, 0x01a6, 0xffff, 0x0082, 0x0136,
+	0xffff, 0x01d4, 0xffff, 0x0113, 0xffff, 0x0005, 0x015e, 0xffff, 0x008c, 0xffff, 0x00d5, 0x0131,
+	0xffff, 0xffff, 0x019b, 0x00c4, 0x0070, 0x00a8, 0xffff, 0x002c, 0x01e2, 0x0037, 0x018c, 0xffff,
+	0x007b, 0x01c8, 0xffff, 0xffff, 0xffff, 0x01dc, 0xffff, 0xffff, 0x01e1, 0xffff, 0x0140, 0x01a2,
+	0x0084, 0xffff, 0xffff, 0x009d, 0x0143, 0xffff, 0x00b1, 0xffff, 0xffff, 0xffff, 0x0091, 0xffff,
+	0xffff, 0xffff, 0x013a, 0x01c7, 0x0194, 0x0040, 0x01ba, 0xffff, 0xffff, 0x0172, 0xffff, 0x001b,
+	0x011e, 0x00d3, 0x007d, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0008, 0x005d, 0x0024, 0x01c1,
+	0xffff, 0xffff, 0xffff, 0xffff, 0x0188, 0x0076, 0xffff, 0x01b4, 0xffff, 0xffff, 0xffff, 0x0142,
+	0xffff, 0x01ca, 0x0192, 0xffff, 0x00fc, 0xffff, 0xffff, 0x006f, 0x0080, 0xffff, 0xffff, 0xffff,
+	0x00c2, 0xffff, 0x00e1, 0x0137, 0x01c6, 0xffff, 0xffff, 0x01ab, 0xffff, 0xffff, 0xffff, 0x012b,
+	0x01a0, 0xffff, 0x0055, 0xffff, 0xffff, 0xffff, 0x00e5, 0xffff, 0xffff, 0x0054, 0xffff, 0x0083,
+	0xffff, 0x0038, 0xffff, 0xffff, 0x0035, 0xffff, 0xffff, 0xffff, 0x014a, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0x009e, 0x01b0, 0x014d, 0xffff, 0x007a, 0xffff, 0xffff, 0xffff, 0x0085, 0x0117,
+	0xffff, 0x003f, 0x0184, 0x003b, 0x0195, 0xffff, 0x0177, 0xffff, 0xffff, 0x00d7, 0xffff, 0xffff,
+	0x007c, 0xffff, 0x0149, 0xffff, 0x000d, 0xffff, 0x0132, 0x002f, 0xffff, 0xffff, 0x013b, 0xffff,
+	0x00d4, 0x0081, 0x00be, 0xffff, 0xffff, 0x009c, 0xffff, 0xffff, 0x016a, 0x0110, 0x0060, 0x00ad,
+	0x0067, 0x0009, 0x00c3, 0x010a, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x019d, 0xffff,
+	0xffff, 0x016e, 0x0047, 0x00a9, 0xffff, 0xffff, 0x00ec, 0x0045, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0x0042, 0x01c5, 0x0193, 0x01de, 0x009b, 0x0094, 0xffff, 0xffff, 0xffff, 0x017f, 0x013c,
+	0xffff, 0x00f8, 0x0006, 0x010d, 0x0028, 0x0034, 0xffff, 0xffff, 0x01b3, 0xffff, 0xffff, 0x0046,
+	0x0128, 0xffff, 0x006a, 0xffff, 0x0102, 0xffff, 0x0029, 0xffff, 0xffff, 0x004d, 0x00e4, 0x01a9,
+	0x01d8, 0x0098, 0x01b8, 0x0176, 0x0164, 0x0162, 0x00dd, 0x0160, 0xffff, 0x0155, 0x0170, 0xffff,
+	0x0185, 0x0071, 0x0093, 0x0050, 0x000e, 0xffff, 0x0183, 0x0072, 0x01a8, 0x00f7, 0xffff, 0xffff,
+	0x017e, 0x01c2, 0x00d0, 0xffff, 0xffff, 0x0017, 0x004b, 0xffff, 0x0039, 0x00d1, 0xffff, 0xffff,
+	0x00bd, 0x0153, 0x0181, 0xffff, 0x0156, 0xffff, 0x000c, 0xffff, 0xffff, 0x018f, 0xffff, 0x01db,
+	0x01ce, 0x010b, 0x01d5, 0xffff, 0xffff, 0x0118, 0x01e0, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0x0161, 0x0178, 0xffff, 0xffff, 0xffff, 0xffff, 0x0026, 0x00e9, 0x0191, 0xffff,
+	0xffff, 0x015c, 0xffff, 0x00cd, 0xffff, 0x014f, 0x001f, 0xffff, 0x0109, 0xffff, 0x01bf, 0xffff,
+	0x0171, 0xffff, 0xffff, 0x00c8, 0xffff, 0xffff, 0x002b, 0x0187, 0x0121, 0x018b, 0x00f9, 0xffff,
+	0xffff, 0x017c, 0xffff, 0xffff, 0xffff, 0x0119, 0xffff, 0xffff, 0x01d2, 0xffff, 0xffff, 0xffff,
+	0xffff, 0x009a, 0x019f, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x0145, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x001c, 0x00ea, 0x01ad, 0x0130, 0x015f, 0x0011, 0xffff,
+	0xffff, 0x0074, 0x0122, 0x0123, 0xffff, 0x0198, 0xffff, 0xffff, 0xffff, 0x014e, 0x0049, 0xffff,
+	0xffff, 0xffff, 0x0174, 0x005c, 0xffff, 0x00a2, 0x01dd, 0xffff, 0xffff, 0x00a4, 0xffff, 0x00c5,
+	0x0044, 0xffff, 0x0032, 0xffff, 0xffff, 0x015d, 0x0020, 0xffff, 0x00af, 0xffff, 0xffff, 0xffff,
+	0x00fa, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x00dc, 0xffff, 0x0077, 0x0167, 0xffff, 0x0141,
+	0xffff, 0xffff, 0x0180, 0x01b1, 0x003d, 0xffff, 0x00f2, 0xffff, 0x0013, 0xffff, 0x008b, 0x00fe,
+	0x00ed, 0x0058, 0xffff, 0x00db, 0xffff, 0xffff, 0x0134, 0xffff, 0x0007, 0xffff, 0x006c, 0x00c6,
+	0x0059, 0xffff, 0xffff, 0xffff, 0x0022, 0xffff, 0x0069, 0xffff, 0x0092, 0x009f, 0x018d, 0xffff,
+	0x012a, 0x01cd, 0x00e7, 0x013e, 0xffff, 0x0023, 0xffff, 0xffff, 0xffff, 0xffff, 0x00c0, 0x0015,
+	0x01da, 0xffff, 0x011c, 0xffff, 0xffff, 0x0146, 0xffff, 0x00a5, 0xffff, 0xffff, 0xffff, 0xffff,
+	0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0x01c0, 0x01a5, 0x008f, 0x011f, 0xffff, 0xffff, 0xffff,
+	0x00de, 0x01bb, 0x002e, 0xffff,
+};
+
+// FNV-1a with the seed folded into the offset basis
+constexpr uint32_t HashGlslWord(const char* text, size_t length, uint32_t seed)
+{
+	uint32_t hash = 2166136261u ^ seed;
+	for (size_t i = 0; i < length; i++)
+		hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+	return hash;
+}
+
+// One probe and one compare, whatever the word
+constexpr GlslWordKind FindGlslWord(const char* text, size_t length)
+{
+	if (length == 0 || length > glslWordMaxLength)
+		return GlslWord_None;
+	uint32_t seed = glslWordDisplacements[HashGlslWord(text, length, 0) % glslWordBucketCount];
+	uint16_t index = glslWordSlots[HashGlslWord(text, length, seed) % glslWordSlotCount];
+	if (index == 0xffff || glslWords[index].length != length)
+		return GlslWord_None;
+	for (size_t i = 0; i < length; i++)
+		if (glslWords[index].text[i] != text[i])
+			return GlslWord_None;
+	return glslWords[index].kind;
+}
+
+static_assert(FindGlslWord("vec3", 4) == GlslWord_Keyword, "GlslWords.h is out of date");
+static_assert(FindGlslWord("smoothstep", 10) == GlslWord_Function, "GlslWords.h is out of date");
+static_assert(FindGlslWord("gl_FragCoord", 12) == GlslWord_Variable, "GlslWords.h is out of date");
+static_assert(FindGlslWord("fragColor", 9) == GlslWord_None, "GlslWords.h is out of date");
@@ -0,0 +1,224 @@
+# Writes GlslWords.h, the perfect hash of GLSL 4.60 keywords and built-ins used by the editor.
+# Run it again after changing the word lists: python GlslWords.py
+
+import os
+
+# 3.6 Keywords, including the ones reserved for future use
+keywords = """
+const uniform buffer shared attribute varying
+coherent volatile restrict readonly writeonly
+atomic_uint layout centroid flat smooth noperspective patch sample invariant precise
+break continue do for while switch case default if else subroutine
+in out inout int void bool true false float double discard return
+vec2 vec3 vec4 ivec2 ivec3 ivec4 bvec2 bvec3 bvec4 uint uvec2 uvec3 uvec4 dvec2 dvec3 dvec4
+mat2 mat3 mat4 mat2x2 mat2x3 mat2x4 mat3x2 mat3x3 mat3x4 mat4x2 mat4x3 mat4x4
+dmat2 dmat3 dmat4 dmat2x2 dmat2x3 dmat2x4 dmat3x2 dmat3x3 dmat3x4 dmat4x2 dmat4x3 dmat4x4
+lowp mediump highp precision
+sampler1D sampler1DShadow sampler1DArray sampler1DArrayShadow isampler1D isampler1DArray usampler1D usampler1DArray
+sampler2D sampler2DShadow sampler2DArray sampler2DArrayShadow isampler2D isampler2DArray usampler2D usampler2DArray
+sampler2DRect sampler2DRectShadow isampler2DRect usampler2DRect
+sampler2DMS isampler2DMS usampler2DMS sampler2DMSArray isampler2DMSArray usampler2DMSArray
+sampler3D isampler3D usampler3D
+samplerCube samplerCubeShadow isamplerCube usamplerCube
+samplerCubeArray samplerCubeArrayShadow isamplerCubeArray usamplerCubeArray
+samplerBuffer isamplerBuffer usamplerBuffer
+image1D iimage1D uimage1D image1DArray iimage1DArray uimage1DArray
+image2D iimage2D uimage2D image2DArray iimage2DArray uimage2DArray
+image2DRect iimage2DRect uimage2DRect image2DMS iimage2DMS uimage2DMS
+image2DMSArray iimage2DMSArray uimage2DMSArray image3D iimage3D uimage3D
+imageCube iimageCube uimageCube imageCubeArray iimageCubeArray uimageCubeArray
+imageBuffer iimageBuffer uimageBuffer
+struct
+common partition active asm class union enum typedef template this resource goto
+inline noinline public static extern external interface long short half fixed unsigned superp
+input output hvec2 hvec3 hvec4 fvec2 fvec3 fvec4 filter sizeof cast namespace using sampler3DRect
+"""
+
+# 8 Built-in Functions, core profile
+functions = """
+radians degrees sin cos tan asin acos atan sinh cosh tanh asinh acosh atanh
+pow exp log exp2 log2 sqrt inversesqrt
+abs sign floor trunc round roundEven ceil fract mod modf min max clamp mix step smoothstep
+isnan isinf floatBitsToInt floatBitsToUint intBitsToFloat uintBitsToFloat fma frexp ldexp
+packUnorm2x16 packSnorm2x16 packUnorm4x8 packSnorm4x8 unpackUnorm2x16 unpackSnorm2x16
+unpackUnorm4x8 unpackSnorm4x8 packHalf2x16 unpackHalf2x16 packDouble2x32 unpackDouble2x32
+length distance dot cross normalize faceforward reflect refract
+matrixCompMult outerProduct transpose determinant inverse
+lessThan lessThanEqual greaterThan greaterThanEqual equal notEqual any all not
+uaddCarry usubBorrow umulExtended imulExtended bitfieldExtract bitfieldInsert bitfieldReverse
+bitCount findLSB findMSB
+textureSize textureQueryLod textureQueryLevels textureSamples
+texture textureProj textureLod textureOffset texelFetch texelFetchOffset textureProjOffset
+textureLodOffset textureProjLod textureProjLodOffset textureGrad textureGradOffset
+textureProjGrad textureProjGradOffset textureGather textureGatherOffset textureGatherOffsets
+atomicCounterIncrement atomicCounterDecrement atomicCounter atomicCounterAdd atomicCounterSubtract
+atomicCounterMin atomicCounterMax atomicCounterAnd atomicCounterOr atomicCounterXor
+atomicCounterExchange atomicCounterCompSwap
+atomicAdd atomicMin atomicMax atomicAnd atomicOr atomicXor atomicExchange atomicCompSwap
+imageSize imageSamples imageLoad imageStore imageAtomicAdd imageAtomicMin imageAtomicMax
+imageAtomicAnd imageAtomicOr imageAtomicXor imageAtomicExchange imageAtomicCompSwap
+EmitStreamVertex EndStreamPrimitive EmitVertex EndPrimitive
+dFdx dFdy dFdxFine dFdyFine dFdxCoarse dFdyCoarse fwidth fwidthFine fwidthCoarse
+interpolateAtCentroid interpolateAtSample interpolateAtOffset
+noise1 noise2 noise3 noise4
+barrier memoryBarrier memoryBarrierAtomicCounter memoryBarrierBuffer memoryBarrierShared
+memoryBarrierImage groupMemoryBarrier anyInvocation allInvocations allInvocationsEqual
+"""
+
+# 7 Built-in Variables and constants
+variables = """
+gl_VertexID gl_InstanceID gl_DrawID gl_BaseVertex gl_BaseInstance
+gl_PerVertex gl_Position gl_PointSize gl_ClipDistance gl_CullDistance
+gl_PatchVerticesIn gl_PrimitiveID gl_InvocationID gl_TessLevelOuter gl_TessLevelInner gl_TessCoord
+gl_in gl_out gl_PrimitiveIDIn gl_Layer gl_ViewportIndex
+gl_FragCoord gl_FrontFacing gl_PointCoord gl_SampleID gl_SamplePosition gl_SampleMaskIn
+gl_HelperInvocation gl_FragDepth gl_SampleMask gl_NumSamples gl_DepthRange
+gl_NumWorkGroups gl_WorkGroupSize gl_WorkGroupID gl_LocalInvocationID gl_GlobalInvocationID
+gl_LocalInvocationIndex
+gl_MaxVertexAttribs gl_MaxVertexUniformVectors gl_MaxVertexUniformComponents
+gl_MaxVertexOutputComponents gl_MaxVaryingComponents gl_MaxVaryingVectors
+gl_MaxVertexTextureImageUnits gl_MaxVertexImageUniforms gl_MaxVertexAtomicCounters
+gl_MaxVertexAtomicCounterBuffers gl_MaxTessPatchComponents gl_MaxPatchVertices gl_MaxTessGenLevel
+gl_MaxTessControlInputComponents gl_MaxTessControlOutputComponents
+gl_MaxTessControlTextureImageUnits gl_MaxTessControlUniformComponents
+gl_MaxTessControlTotalOutputComponents gl_MaxTessControlImageUniforms
+gl_MaxTessControlAtomicCounters gl_MaxTessControlAtomicCounterBuffers
+gl_MaxTessEvaluationInputComponents gl_MaxTessEvaluationOutputComponents
+gl_MaxTessEvaluationTextureImageUnits gl_MaxTessEvaluationUniformComponents
+gl_MaxTessEvaluationImageUniforms gl_MaxTessEvaluationAtomicCounters
+gl_MaxTessEvaluationAtomicCounterBuffers gl_MaxGeometryInputComponents
+gl_MaxGeometryOutputComponents gl_MaxGeometryImageUniforms gl_MaxGeometryTextureImageUnits
+gl_MaxGeometryOutputVertices gl_MaxGeometryTotalOutputComponents gl_MaxGeometryUniformComponents
+gl_MaxGeometryAtomicCounters gl_MaxGeometryAtomicCounterBuffers gl_MaxFragmentImageUniforms
+gl_MaxFragmentInputComponents gl_MaxFragmentUniformVectors gl_MaxFragmentUniformComponents
+gl_MaxFragmentAtomicCounters gl_MaxFragmentAtomicCounterBuffers gl_MaxDrawBuffers
+gl_MaxTextureImageUnits gl_MinProgramTexelOffset gl_MaxProgramTexelOffset gl_MaxImageUnits
+gl_MaxSamples gl_MaxImageSamples gl_MaxClipDistances gl_MaxCullDistances gl_MaxViewports
+gl_MaxComputeImageUniforms gl_MaxComputeWorkGroupCount gl_MaxComputeWorkGroupSize
+gl_MaxComputeUniformComponents gl_MaxComputeTextureImageUnits gl_MaxComputeAtomicCounters
+gl_MaxComputeAtomicCounterBuffers gl_MaxCombinedTextureImageUnits gl_MaxCombinedImageUniforms
+gl_MaxCombinedImageUnitsAndFragmentOutputs gl_MaxCombinedShaderOutputResources
+gl_MaxCombinedAtomicCounters gl_MaxCombinedAtomicCounterBuffers gl_MaxCombinedClipAndCullDistances
+gl_MaxAtomicCounterBindings gl_MaxAtomicCounterBufferSize gl_MaxTransformFeedbackBuffers
+gl_MaxTransformFeedbackInterleavedComponents
+"""
+
+slotCount = 1024
+bucketCount = 256
+
+words = []
+for kind, text in (("GlslWord_Keyword", keywords), ("GlslWord_Function", functions), ("GlslWord_Variable", variables)):
+	for word in text.split():
+		words.append((word, kind))
+names = [w for w, k in words]
+assert len(names) == len(set(names)), "duplicate word"
+assert len(words) < slotCount and max(len(n) for n in names) < 256
+
+# same as HashGlslWord in the header
+def Hash(text, seed):
+	h = (2166136261 ^ seed) & 0xffffffff
+	for c in text.encode():
+		h = ((h ^ c) * 16777619) & 0xffffffff
+	return h
+
+# Hash and displace: every bucket gets the first seed that puts all of its words into free slots,
+# biggest buckets first while there is still room
+buckets = [[] for _ in range(bucketCount)]
+for index, (word, kind) in enumerate(words):
+	buckets[Hash(word, 0) % bucketCount].append(index)
+
+displacements = [0] * bucketCount
+slots = [0xffff] * slotCount
+for bucket in sorted(range(bucketCount), key=lambda b: -len(buckets[b])):
+	if not buckets[bucket]:
+		break
+	seed = 1
+	while True:
+		taken = [Hash(words[i][0], seed) % slotCount for i in buckets[bucket]]
+		if len(set(taken)) == len(taken) and all(slots[s] == 0xffff for s in taken):
+			break
+		seed += 1
+	displacements[bucket] = seed
+	for i, s in zip(buckets[bucket], taken):
+		slots[s] = i
+
+def Rows(values, perRow):
+	return "\n".join("\t" + " ".join("%s," % v for v in values[i:i + perRow]) for i in range(0, len(values), perRow))
+
+out = []
+out.append("#pragma once")
+out.append("#include <stddef.h>")
+out.append("#include <stdint.h>")
+out.append("")
+out.append("// Generated by GlslWords.py, edit the word lists there and run it again.")
+out.append("// GLSL 4.60 keywords and built-ins as a perfect hash, so the colorizer can classify an")
+out.append("// identifier in place without copying it into a std::string first.")
+out.append("")
+out.append("enum GlslWordKind : uint8_t")
+out.append("{")
+out.append("\tGlslWord_None,")
+out.append("\tGlslWord_Keyword,")
+out.append("\tGlslWord_Function,")
+out.append("\tGlslWord_Variable,")
+out.append("};")
+out.append("")
+out.append("struct GlslWord")
+out.append("{")
+out.append("\tconst char* text;")
+out.append("\tuint8_t length;")
+out.append("\tGlslWordKind kind;")
+out.append("};")
+out.append("")
+out.append("constexpr GlslWord glslWords[] = {")
+for word, kind in words:
+	out.append('\t{ "%s", %d, %s },' % (word, len(word), kind))
+out.append("};")
+out.append("")
+out.append("constexpr uint32_t glslWordSlotCount = %d;" % slotCount)
+out.append("constexpr uint32_t glslWordBucketCount = %d;" % bucketCount)
+out.append("constexpr size_t glslWordMaxLength = %d;" % max(len(n) for n in names))
+out.append("")
+out.append("// seed of the second hash for each bucket of the first one")
+out.append("constexpr uint16_t glslWordDisplacements[glslWordBucketCount] = {")
+out.append(Rows(displacements, 16))
+out.append("};")
+out.append("")
+out.append("// index into glslWords, 0xffff for an empty slot")
+out.append("constexpr uint16_t glslWordSlots[glslWordSlotCount] = {")
+out.append(Rows(["0x%04x" % s for s in slots], 12))
+out.append("};")
+out.append("")
+out.append("// FNV-1a with the seed folded into the offset basis")
+out.append("constexpr uint32_t HashGlslWord(const char* text, size_t length, uint32_t seed)")
+out.append("{")
+out.append("\tuint32_t hash = 2166136261u ^ seed;")
+out.append("\tfor (size_t i = 0; i < length; i++)")
+out.append("\t\thash = (hash ^ (uint8_t)text[i]) * 16777619u;")
+out.append("\treturn hash;")
+out.append("}")
+out.append("")
+out.append("// One probe and one compare, whatever the word")
+out.append("constexpr GlslWordKind FindGlslWord(const char* text, size_t length)")
+out.append("{")
+out.append("\tif (length == 0 || length > glslWordMaxLength)")
+out.append("\t\treturn GlslWord_None;")
+out.append("\tuint32_t seed = glslWordDisplacements[HashGlslWord(text, length, 0) % glslWordBucketCount];")
+out.append("\tuint16_t index = glslWordSlots[HashGlslWord(text, length, seed) % glslWordSlotCount];")
+out.append("\tif (index == 0xffff || glslWords[index].length != length)")
+out.append("\t\treturn GlslWord_None;")
+out.append("\tfor (size_t i = 0; i < length; i++)")
+out.append("\t\tif (glslWords[index].text[i] != text[i])")
+out.append("\t\t\treturn GlslWord_None;")
+out.append("\treturn glslWords[index].kind;")
+out.append("}")
+out.append("")
+out.append('static_assert(FindGlslWord("vec3", 4) == GlslWord_Keyword, "GlslWords.h is out of date");')
+out.append('static_assert(FindGlslWord("smoothstep", 10) == GlslWord_Function, "GlslWords.h is out of date");')
+out.append('static_assert(FindGlslWord("gl_FragCoord", 12) == GlslWord_Variable, "GlslWords.h is out of date");')
+out.append('static_assert(FindGlslWord("fragColor", 9) == GlslWord_None, "GlslWords.h is out of date");')
+out.append("")
+
+path = os.path.join(os.path.dirname(os.path.abspath(__file__)), "GlslWords.h")
+with open(path, "w", newline="\n") as f:
+	f.write("\n".join(out))
+print("%d words, %d slots, %d buckets" % (len(words), slotCount, bucketCount))
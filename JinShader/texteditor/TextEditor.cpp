@@ -3,11 +3,14 @@
 #include <string>
 #include <regex>
 #include <cmath>
+#include <cstring>
 
 #include "TextEditor.h"
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include "../imgui/imgui.h" // for imGui::GetCurrentWindow()
+#include "../Trace.h"
+#include "GlslWords.h"
 
 // TODO
 // - multiline comments vs single-line: latter is blocking start of a ML
@@ -27,6 +30,7 @@ bool equals(InputIt1 first1, InputIt1 last1,
 TextEditor::TextEditor()
 	: mLineSpacing(1.0f)
 	, mUndoIndex(0)
+	, mUndoMemoryBudget(64 << 20)
 	, mTabSize(4)
 	, mOverwrite(false)
 	, mReadOnly(false)
@@ -35,13 +39,32 @@ TextEditor::TextEditor()
 	, mScrollToTop(false)
 	, mTextChanged(false)
 	, mColorizerEnabled(true)
+	, mColorizeMilliseconds(0.0f)
 	, mTextStart(20.0f)
 	, mLeftMargin(10)
 	, mCursorPositionChanged(false)
 	, mColorRangeMin(0)
 	, mColorRangeMax(0)
 	, mSelectionMode(SelectionMode::Normal)
+	, mPaletteAlpha(-1.0f)
 	, mCheckComments(true)
+	, mCheckCommentsMin(0)
+	, mCheckCommentsMax(std::numeric_limits<int>::max())
+	, mTextVersion(0)
+	, mVisibleLineMin(0)
+	, mVisibleLineMax(0)
+	, mColorizePending(0)
+	, mColorizeNotify(nullptr)
+	, mColorizeQuit(false)
+	, mDiagnostics(nullptr)
+	, mDiagnosticsVersion(0)
+	, mLayoutFont(nullptr)
+	, mLayoutFontSize(0.0f)
+	, mLayoutTabSize(0)
+	, mLayoutStamp(1)
+	, mSpaceSize(0.0f)
+	, mAsciiAdvance()
+	, mMonospace(false)
 	, mLastClick(-1.0f)
 	, mHandleKeyboardInputs(true)
 	, mHandleMouseInputs(true)
@@ -56,10 +79,12 @@ TextEditor::TextEditor()
 
 TextEditor::~TextEditor()
 {
+	StopColorizeWorker();
 }
 
 void TextEditor::SetLanguageDefinition(const LanguageDefinition& aLanguageDef)
 {
+	StopColorizeWorker();
 	mLanguageDefinition = aLanguageDef;
 	mRegexList.clear();
 
@@ -72,6 +97,7 @@ void TextEditor::SetLanguageDefinition(const LanguageDefinition& aLanguageDef)
 void TextEditor::SetPalette(const Palette& aValue)
 {
 	mPaletteBase = aValue;
+	mPaletteAlpha = -1.0f;
 }
 
 std::string TextEditor::GetText(const Coordinates& aStart, const Coordinates& aEnd) const
@@ -97,8 +123,10 @@ std::string TextEditor::GetText(const Coordinates& aStart, const Coordinates& aE
 		auto& line = mLines[lstart];
 		if (istart < (int)line.size())
 		{
-			result += line[istart].mChar;
-			istart++;
+			// the rest of the line, or up to iend on the last one
+			auto to = lstart < lend ? (int)line.size() : std::min(iend, (int)line.size());
+			result.append(line.mChars, istart, to - istart);
+			istart = to;
 		}
 		else
 		{
@@ -235,38 +263,39 @@ void TextEditor::DeleteRange(const Coordinates& aStart, const Coordinates& aEnd)
 		auto& line = mLines[aStart.mLine];
 		auto n = GetLineMaxColumn(aStart.mLine);
 		if (aEnd.mColumn >= n)
-			line.erase(line.begin() + start, line.end());
+			line.erase(start, line.size());
 		else
-			line.erase(line.begin() + start, line.begin() + end);
+			line.erase(start, end);
 	}
 	else
 	{
 		auto& firstLine = mLines[aStart.mLine];
 		auto& lastLine = mLines[aEnd.mLine];
 
-		firstLine.erase(firstLine.begin() + start, firstLine.end());
-		lastLine.erase(lastLine.begin(), lastLine.begin() + end);
+		firstLine.erase(start, firstLine.size());
+		lastLine.erase(0, end);
 
 		if (aStart.mLine < aEnd.mLine)
-			firstLine.insert(firstLine.end(), lastLine.begin(), lastLine.end());
+			firstLine.insert(firstLine.size(), lastLine, 0, lastLine.size());
 
 		if (aStart.mLine < aEnd.mLine)
 			RemoveLine(aStart.mLine + 1, aEnd.mLine + 1);
 	}
 
 	mTextChanged = true;
+	CheckComments(aStart.mLine, aStart.mLine + 1);
 }
 
 int TextEditor::InsertTextAt(Coordinates& /* inout */ aWhere, const char* aValue)
 {
 	assert(!mReadOnly);
 
-	int cindex = GetCharacterIndex(aWhere);
-	int totalLines = 0;
+	// Build the new lines first and insert them in one go. Inserting them one at a time shifts
+	// every following line per inserted line, which made pasting into a large file quadratic.
+	std::vector<Line> newLines(1);
+	int column = aWhere.mColumn;
 	while (*aValue != '\0')
 	{
-		assert(!mLines.empty());
-
 		if (*aValue == '\r')
 		{
 			// skip
@@ -274,35 +303,45 @@ int TextEditor::InsertTextAt(Coordinates& /* inout */ aWhere, const char* aValue
 		}
 		else if (*aValue == '\n')
 		{
-			if (cindex < (int)mLines[aWhere.mLine].size())
-			{
-				auto& newLine = InsertLine(aWhere.mLine + 1);
-				auto& line = mLines[aWhere.mLine];
-				newLine.insert(newLine.begin(), line.begin() + cindex, line.end());
-				line.erase(line.begin() + cindex, line.end());
-			}
-			else
-			{
-				InsertLine(aWhere.mLine + 1);
-			}
-			++aWhere.mLine;
-			aWhere.mColumn = 0;
-			cindex = 0;
-			++totalLines;
+			newLines.emplace_back();
+			column = 0;
 			++aValue;
 		}
 		else
 		{
-			auto& line = mLines[aWhere.mLine];
+			auto& line = newLines.back();
 			auto d = UTF8CharLength(*aValue);
 			while (d-- > 0 && *aValue != '\0')
-				line.insert(line.begin() + cindex++, Glyph(*aValue++, PaletteIndex::Default));
-			++aWhere.mColumn;
+				line.push_back(Glyph(*aValue++, PaletteIndex::Default));
+			++column;
 		}
+	}
 
-		mTextChanged = true;
+	int startLine = aWhere.mLine;
+	int totalLines = (int)newLines.size() - 1;
+	auto& line = mLines[startLine];
+	int cindex = GetCharacterIndex(aWhere);
+	if (totalLines > 0)
+	{
+		// the rest of the line moves to the end of the last inserted line
+		auto& lastLine = newLines.back();
+		lastLine.insert(lastLine.size(), line, cindex, line.size());
+		line.erase(cindex, line.size());
 	}
+	line.insert(cindex, newLines.front(), 0, newLines.front().size());
 
+	if (totalLines > 0)
+	{
+		InsertLines(startLine + 1, totalLines);
+		std::move(newLines.begin() + 1, newLines.end(), mLines.begin() + startLine + 1);
+	}
+
+	aWhere.mLine = startLine + totalLines;
+	aWhere.mColumn = column;
+	if (newLines.size() > 1 || !newLines.front().empty())
+		mTextChanged = true;
+
+	CheckComments(startLine, aWhere.mLine + 1);
 	return totalLines;
 }
 
@@ -316,9 +355,134 @@ void TextEditor::AddUndo(UndoRecord& aValue)
 	//	aValue.mAfter.mCursorPosition.mLine, aValue.mAfter.mCursorPosition.mColumn
 	//	);
 
-	mUndoBuffer.resize((size_t)(mUndoIndex + 1));
-	mUndoBuffer.back() = aValue;
-	++mUndoIndex;
+	// Whatever could be redone is gone now
+	const bool atEnd = mUndoIndex == (int)mUndoBuffer.size();
+	if (!atEnd)
+	{
+		mUndoText.resize(mUndoBuffer[mUndoIndex].mText);
+		mUndoBuffer.resize((size_t)mUndoIndex);
+	}
+
+	if (!atEnd || mUndoBuffer.empty() || !MergeUndo(mUndoBuffer.back(), aValue))
+	{
+		UndoEntry entry;
+		entry.mText = mUndoText.size();
+		entry.mRemovedLength = aValue.mRemoved.size();
+		entry.mAddedLength = aValue.mAdded.size();
+		entry.mCanMerge = IsMergeableUndo(aValue);
+		entry.mAddedStart = aValue.mAddedStart;
+		entry.mAddedEnd = aValue.mAddedEnd;
+		entry.mRemovedStart = aValue.mRemovedStart;
+		entry.mRemovedEnd = aValue.mRemovedEnd;
+		entry.mBefore = aValue.mBefore;
+		entry.mAfter = aValue.mAfter;
+
+		mUndoText.append(aValue.mRemoved.c_str(), aValue.mRemoved.size() + 1);
+		mUndoText.append(aValue.mAdded.c_str(), aValue.mAdded.size() + 1);
+		mUndoBuffer.push_back(entry);
+	}
+	mUndoIndex = (int)mUndoBuffer.size();
+
+	TrimUndo();
+}
+
+// One character typed or deleted, other than a newline or a tab
+bool TextEditor::IsMergeableUndo(const UndoRecord& aValue)
+{
+	if (aValue.mAdded.empty() == aValue.mRemoved.empty())
+		return false;
+	const auto& text = aValue.mAdded.empty() ? aValue.mRemoved : aValue.mAdded;
+	return UTF8CharLength((uint8_t)text[0]) == (int)text.size() && text[0] != '\n' && text[0] != '\t';
+}
+
+// Folds a single typed or deleted character into the last step when it carries on from there
+// with the cursor untouched in between. Newlines, tabs and the start of a new word begin a new step.
+bool TextEditor::MergeUndo(UndoEntry& aLast, const UndoRecord& aValue)
+{
+	auto sameState = [](const EditorState& a, const EditorState& b)
+	{
+		return a.mCursorPosition == b.mCursorPosition && a.mSelectionStart == b.mSelectionStart && a.mSelectionEnd == b.mSelectionEnd;
+	};
+	if (!aLast.mCanMerge || !IsMergeableUndo(aValue) || !sameState(aLast.mAfter, aValue.mBefore))
+		return false;
+
+	const auto& text = aValue.mAdded.empty() ? aValue.mRemoved : aValue.mAdded;
+
+	if (!aValue.mAdded.empty())
+	{
+		// typing, the last step must be typing too, its text ends the buffer
+		if (aLast.mRemovedLength != 0 || aValue.mAddedStart != aLast.mAddedEnd)
+			return false;
+		const char* added = mUndoText.c_str() + aLast.mText + aLast.mRemovedLength + 1;
+		const char prev = added[aLast.mAddedLength - 1];
+		if (isspace((uint8_t)text[0]) && !isspace((uint8_t)prev))
+			return false;
+
+		mUndoText.insert(mUndoText.size() - 1, text);
+		aLast.mAddedLength += text.size();
+		aLast.mAddedEnd = aValue.mAddedEnd;
+	}
+	else
+	{
+		if (aLast.mRemovedLength == 0 || aValue.mRemovedStart.mLine != aLast.mRemovedStart.mLine)
+			return false;
+
+		if (aValue.mRemovedEnd == aLast.mRemovedStart)
+		{
+			// backspace
+			mUndoText.insert(aLast.mText, text);
+			aLast.mRemovedStart = aValue.mRemovedStart;
+		}
+		else if (aValue.mRemovedStart == aLast.mRemovedStart)
+		{
+			// delete, the cursor stays and the removed text grows to the right
+			mUndoText.insert(aLast.mText + aLast.mRemovedLength, text);
+			aLast.mRemovedEnd.mColumn += aValue.mRemovedEnd.mColumn - aValue.mRemovedStart.mColumn;
+		}
+		else
+			return false;
+		aLast.mRemovedLength += text.size();
+	}
+
+	aLast.mAfter = aValue.mAfter;
+	return true;
+}
+
+size_t TextEditor::GetUndoMemoryUsage() const
+{
+	return mUndoText.size() + mUndoBuffer.size() * sizeof(UndoEntry);
+}
+
+void TextEditor::SetUndoMemoryBudget(size_t aBytes)
+{
+	mUndoMemoryBudget = aBytes;
+	TrimUndo();
+}
+
+// Over budget, drops the oldest steps down to 3/4 of it so the buffer is not shifted on every edit.
+// Only steps that can be undone are dropped, never the last one.
+void TextEditor::TrimUndo()
+{
+	size_t usage = GetUndoMemoryUsage();
+	if (usage <= mUndoMemoryBudget)
+		return;
+
+	const size_t target = mUndoMemoryBudget / 4 * 3;
+	size_t drop = 0;
+	while (usage > target && drop < (size_t)mUndoIndex && drop + 1 < mUndoBuffer.size())
+	{
+		usage -= mUndoBuffer[drop + 1].mText - mUndoBuffer[drop].mText + sizeof(UndoEntry);
+		++drop;
+	}
+	if (drop == 0)
+		return;
+
+	const size_t textOffset = mUndoBuffer[drop].mText;
+	mUndoText.erase(0, textOffset);
+	mUndoBuffer.erase(mUndoBuffer.begin(), mUndoBuffer.begin() + drop);
+	for (auto& entry : mUndoBuffer)
+		entry.mText -= textOffset;
+	mUndoIndex -= (int)drop;
 }
 
 TextEditor::Coordinates TextEditor::ScreenPosToCoordinates(const ImVec2& aPosition) const
@@ -333,40 +497,26 @@ TextEditor::Coordinates TextEditor::ScreenPosToCoordinates(const ImVec2& aPositi
 	if (lineNo >= 0 && lineNo < (int)mLines.size())
 	{
 		auto& line = mLines.at(lineNo);
+		UpdateLineLayout(line);
 
 		int columnIndex = 0;
 		float columnX = 0.0f;
 
 		while ((size_t)columnIndex < line.size())
 		{
-			float columnWidth = 0.0f;
-
-			if (line[columnIndex].mChar == '\t')
-			{
-				float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ").x;
-				float oldX = columnX;
-				float newColumnX = (1.0f + std::floor((1.0f + columnX) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-				columnWidth = newColumnX - oldX;
-				if (mTextStart + columnX + columnWidth * 0.5f > local.x)
-					break;
-				columnX = newColumnX;
-				columnCoord = (columnCoord / mTabSize) * mTabSize + mTabSize;
-				columnIndex++;
-			}
+			const bool tab = line.mChars[columnIndex] == '\t';
+			const int next = tab ? columnIndex + 1 : std::min((int)line.size(), columnIndex + UTF8CharLength(line.mChars[columnIndex]));
+			float newColumnX;
+			if (!line.mLayout.empty())
+				newColumnX = line.mLayout[next];
 			else
-			{
-				char buf[7];
-				auto d = UTF8CharLength(line[columnIndex].mChar);
-				int i = 0;
-				while (i < 6 && d-- > 0)
-					buf[i++] = line[columnIndex++].mChar;
-				buf[i] = '\0';
-				columnWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf).x;
-				if (mTextStart + columnX + columnWidth * 0.5f > local.x)
-					break;
-				columnX += columnWidth;
-				columnCoord++;
-			}
+				newColumnX = columnX + mSpaceSize;
+
+			if (mTextStart + (columnX + newColumnX) * 0.5f > local.x)
+				break;
+			columnX = newColumnX;
+			columnCoord = tab ? (columnCoord / mTabSize) * mTabSize + mTabSize : columnCoord + 1;
+			columnIndex = next;
 		}
 	}
 
@@ -578,15 +728,15 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
 	assert(aEnd >= aStart);
 	assert(mLines.size() > (size_t)(aEnd - aStart));
 
-	ErrorMarkers etmp;
-	for (auto& i : mErrorMarkers)
+	DiagnosticLines etmp;
+	for (auto& i : mDiagnosticLines)
 	{
-		ErrorMarkers::value_type e(i.first >= aStart ? i.first - 1 : i.first, i.second);
+		DiagnosticLines::value_type e(i.first >= aStart ? i.first - 1 : i.first, i.second);
 		if (e.first >= aStart && e.first <= aEnd)
 			continue;
 		etmp.insert(e);
 	}
-	mErrorMarkers = std::move(etmp);
+	mDiagnosticLines = std::move(etmp);
 
 	Breakpoints btmp;
 	for (auto i : mBreakpoints)
@@ -599,6 +749,11 @@ void TextEditor::RemoveLine(int aStart, int aEnd)
 
 	mLines.erase(mLines.begin() + aStart, mLines.begin() + aEnd);
 	assert(!mLines.empty());
+	// the next line now starts where the first removed one did
+	if (mLineStates.size() == mLines.size() + 1 + (aEnd - aStart))
+		mLineStates.erase(mLineStates.begin() + aStart + 1, mLineStates.begin() + aEnd + 1);
+	ShiftColorRange(aStart, aStart - aEnd);
+	CheckComments(aStart, aStart + 1);
 
 	mTextChanged = true;
 }
@@ -608,15 +763,15 @@ void TextEditor::RemoveLine(int aIndex)
 	assert(!mReadOnly);
 	assert(mLines.size() > 1);
 
-	ErrorMarkers etmp;
-	for (auto& i : mErrorMarkers)
+	DiagnosticLines etmp;
+	for (auto& i : mDiagnosticLines)
 	{
-		ErrorMarkers::value_type e(i.first > aIndex ? i.first - 1 : i.first, i.second);
+		DiagnosticLines::value_type e(i.first > aIndex ? i.first - 1 : i.first, i.second);
 		if (e.first - 1 == aIndex)
 			continue;
 		etmp.insert(e);
 	}
-	mErrorMarkers = std::move(etmp);
+	mDiagnosticLines = std::move(etmp);
 
 	Breakpoints btmp;
 	for (auto i : mBreakpoints)
@@ -629,27 +784,54 @@ void TextEditor::RemoveLine(int aIndex)
 
 	mLines.erase(mLines.begin() + aIndex);
 	assert(!mLines.empty());
+	if (mLineStates.size() == mLines.size() + 2)
+		mLineStates.erase(mLineStates.begin() + aIndex + 1);
+	ShiftColorRange(aIndex, -1);
+	CheckComments(aIndex, aIndex + 1);
 
 	mTextChanged = true;
 }
 
+// Lines inserted at aIndex for a positive aCount, removed from there for a negative one. The
+// lines still waiting for colors move with the text.
+void TextEditor::ShiftColorRange(int aIndex, int aCount)
+{
+	if (mColorRangeMin >= mColorRangeMax)
+		return;
+	if (mColorRangeMin > aIndex)
+		mColorRangeMin = std::max(aIndex, mColorRangeMin + aCount);
+	if (mColorRangeMax > aIndex)
+		mColorRangeMax = std::max(aIndex, mColorRangeMax + aCount);
+}
+
 TextEditor::Line& TextEditor::InsertLine(int aIndex)
+{
+	InsertLines(aIndex, 1);
+	return mLines[aIndex];
+}
+
+void TextEditor::InsertLines(int aIndex, int aCount)
 {
 	assert(!mReadOnly);
 
-	auto& result = *mLines.insert(mLines.begin() + aIndex, Line());
+	mLines.insert(mLines.begin() + aIndex, aCount, Line());
+	// the new lines start where the one they pushed down did
+	if (mLineStates.size() == mLines.size() + 1 - aCount)
+		mLineStates.insert(mLineStates.begin() + aIndex, aCount, mLineStates[aIndex]);
+	if (mCheckComments && mCheckCommentsMax > aIndex && mCheckCommentsMax < std::numeric_limits<int>::max() - aCount)
+		mCheckCommentsMax += aCount;
+	ShiftColorRange(aIndex, aCount);
+	CheckComments(aIndex, aIndex + aCount);
 
-	ErrorMarkers etmp;
-	for (auto& i : mErrorMarkers)
-		etmp.insert(ErrorMarkers::value_type(i.first >= aIndex ? i.first + 1 : i.first, i.second));
-	mErrorMarkers = std::move(etmp);
+	DiagnosticLines etmp;
+	for (auto& i : mDiagnosticLines)
+		etmp.insert(DiagnosticLines::value_type(i.first >= aIndex ? i.first + aCount : i.first, i.second));
+	mDiagnosticLines = std::move(etmp);
 
 	Breakpoints btmp;
 	for (auto i : mBreakpoints)
-		btmp.insert(i >= aIndex ? i + 1 : i);
+		btmp.insert(i >= aIndex ? i + aCount : i);
 	mBreakpoints = std::move(btmp);
-
-	return result;
 }
 
 std::string TextEditor::GetWordUnderCursor() const
@@ -663,15 +845,13 @@ std::string TextEditor::GetWordAt(const Coordinates& aCoords) const
 	auto start = FindWordStart(aCoords);
 	auto end = FindWordEnd(aCoords);
 
-	std::string r;
+	auto& chars = mLines[aCoords.mLine].mChars;
+	auto istart = std::min(GetCharacterIndex(start), (int)chars.size());
+	auto iend = std::min(GetCharacterIndex(end), (int)chars.size());
+	if (iend <= istart)
+		return std::string();
 
-	auto istart = GetCharacterIndex(start);
-	auto iend = GetCharacterIndex(end);
-
-	for (auto it = istart; it < iend; ++it)
-		r.push_back(mLines[aCoords.mLine][it].mChar);
-
-	return r;
+	return chars.substr(istart, iend - istart);
 }
 
 ImU32 TextEditor::GetGlyphColor(const Glyph& aGlyph) const
@@ -682,17 +862,9 @@ ImU32 TextEditor::GetGlyphColor(const Glyph& aGlyph) const
 		return mPalette[(int)PaletteIndex::Comment];
 	if (aGlyph.mMultiLineComment)
 		return mPalette[(int)PaletteIndex::MultiLineComment];
-	auto const color = mPalette[(int)aGlyph.mColorIndex];
 	if (aGlyph.mPreprocessor)
-	{
-		const auto ppcolor = mPalette[(int)PaletteIndex::Preprocessor];
-		const int c0 = ((ppcolor & 0xff) + (color & 0xff)) / 2;
-		const int c1 = (((ppcolor >> 8) & 0xff) + ((color >> 8) & 0xff)) / 2;
-		const int c2 = (((ppcolor >> 16) & 0xff) + ((color >> 16) & 0xff)) / 2;
-		const int c3 = (((ppcolor >> 24) & 0xff) + ((color >> 24) & 0xff)) / 2;
-		return ImU32(c0 | (c1 << 8) | (c2 << 16) | (c3 << 24));
-	}
-	return color;
+		return mPreprocPalette[(int)aGlyph.mColorIndex];
+	return mPalette[(int)aGlyph.mColorIndex];
 }
 
 void TextEditor::HandleKeyboardInputs()
@@ -853,19 +1025,29 @@ void TextEditor::HandleMouseInputs()
 
 void TextEditor::Render()
 {
-	/* Compute mCharAdvance regarding to scaled font size (Ctrl + mouse wheel)*/
-	const float fontSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, "#", nullptr, nullptr).x;
-	mCharAdvance = ImVec2(fontSize, ImGui::GetTextLineHeightWithSpacing() * mLineSpacing);
-
 	/* Update palette with the current alpha from style */
-	for (int i = 0; i < (int)PaletteIndex::Max; ++i)
+	if (ImGui::GetStyle().Alpha != mPaletteAlpha)
 	{
-		auto color = ImGui::ColorConvertU32ToFloat4(mPaletteBase[i]);
-		color.w *= ImGui::GetStyle().Alpha;
-		mPalette[i] = ImGui::ColorConvertFloat4ToU32(color);
-	}
+		mPaletteAlpha = ImGui::GetStyle().Alpha;
+		for (int i = 0; i < (int)PaletteIndex::Max; ++i)
+		{
+			auto color = ImGui::ColorConvertU32ToFloat4(mPaletteBase[i]);
+			color.w *= mPaletteAlpha;
+			mPalette[i] = ImGui::ColorConvertFloat4ToU32(color);
+		}
 
-	assert(mLineBuffer.empty());
+		// Preprocessor lines blend the token color half way to the preprocessor color
+		const auto ppcolor = mPalette[(int)PaletteIndex::Preprocessor];
+		for (int i = 0; i < (int)PaletteIndex::Max; ++i)
+		{
+			const auto color = mPalette[i];
+			const int c0 = ((ppcolor & 0xff) + (color & 0xff)) / 2;
+			const int c1 = (((ppcolor >> 8) & 0xff) + ((color >> 8) & 0xff)) / 2;
+			const int c2 = (((ppcolor >> 16) & 0xff) + ((color >> 16) & 0xff)) / 2;
+			const int c3 = (((ppcolor >> 24) & 0xff) + ((color >> 24) & 0xff)) / 2;
+			mPreprocPalette[i] = ImU32(c0 | (c1 << 8) | (c2 << 16) | (c3 << 24));
+		}
+	}
 
 	auto contentSize = ImGui::GetWindowContentRegionMax();
 	auto drawList = ImGui::GetWindowDrawList();
@@ -884,15 +1066,17 @@ void TextEditor::Render()
 	auto lineNo = (int)floor(scrollY / mCharAdvance.y);
 	auto globalLineMax = (int)mLines.size();
 	auto lineMax = std::max(0, std::min((int)mLines.size() - 1, lineNo + (int)floor((scrollY + contentSize.y) / mCharAdvance.y)));
+	mVisibleLineMin = lineNo;
+	mVisibleLineMax = lineMax + 1;
 
 	// Deduce mTextStart by evaluating mLines size (global lineMax) plus two spaces as text width
 	char buf[16];
 	snprintf(buf, 16, " %d ", globalLineMax);
-	mTextStart = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x + mLeftMargin;
+	mTextStart = GetAsciiTextWidth(buf) + mLeftMargin;
 
 	if (!mLines.empty())
 	{
-		float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
+		const float spaceSize = mSpaceSize;
 
 		while (lineNo <= lineMax)
 		{
@@ -900,23 +1084,26 @@ void TextEditor::Render()
 			ImVec2 textScreenPos = ImVec2(lineStartScreenPos.x + mTextStart, lineStartScreenPos.y);
 
 			auto& line = mLines[lineNo];
-			longest = std::max(mTextStart + TextDistanceToLineStart(Coordinates(lineNo, GetLineMaxColumn(lineNo))), longest);
-			auto columnNo = 0;
-			Coordinates lineStartCoord(lineNo, 0);
-			Coordinates lineEndCoord(lineNo, GetLineMaxColumn(lineNo));
-
+			UpdateLineLayout(line);
+			longest = std::max(mTextStart + GetLineX(lineNo, (int)line.size()), longest);
 			// Draw selection for the current line
 			float sstart = -1.0f;
 			float ssend = -1.0f;
 
 			assert(mState.mSelectionStart <= mState.mSelectionEnd);
-			if (mState.mSelectionStart <= lineEndCoord)
-				sstart = mState.mSelectionStart > lineStartCoord ? TextDistanceToLineStart(mState.mSelectionStart) : 0.0f;
-			if (mState.mSelectionEnd > lineStartCoord)
-				ssend = TextDistanceToLineStart(mState.mSelectionEnd < lineEndCoord ? mState.mSelectionEnd : lineEndCoord);
+			if (mState.mSelectionStart.mLine <= lineNo && mState.mSelectionEnd.mLine >= lineNo)
+			{
+				Coordinates lineStartCoord(lineNo, 0);
+				Coordinates lineEndCoord(lineNo, GetLineMaxColumn(lineNo));
+
+				if (mState.mSelectionStart <= lineEndCoord)
+					sstart = mState.mSelectionStart > lineStartCoord ? TextDistanceToLineStart(mState.mSelectionStart) : 0.0f;
+				if (mState.mSelectionEnd > lineStartCoord)
+					ssend = TextDistanceToLineStart(mState.mSelectionEnd < lineEndCoord ? mState.mSelectionEnd : lineEndCoord);
 
-			if (mState.mSelectionEnd.mLine > lineNo)
-				ssend += mCharAdvance.x;
+				if (mState.mSelectionEnd.mLine > lineNo)
+					ssend += mCharAdvance.x;
+			}
 
 			if (sstart != -1 && ssend != -1 && sstart < ssend)
 			{
@@ -934,31 +1121,14 @@ void TextEditor::Render()
 				drawList->AddRectFilled(start, end, mPalette[(int)PaletteIndex::Breakpoint]);
 			}
 
-			// Draw error markers
-			auto errorIt = mErrorMarkers.find(lineNo + 1);
-			if (errorIt != mErrorMarkers.end())
-			{
-				auto end = ImVec2(lineStartScreenPos.x + contentSize.x + 2.0f * scrollX, lineStartScreenPos.y + mCharAdvance.y);
-				drawList->AddRectFilled(start, end, mPalette[(int)PaletteIndex::ErrorMarker]);
-
-				if (ImGui::IsMouseHoveringRect(lineStartScreenPos, end))
-				{
-					ImGui::BeginTooltip();
-					ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.2f, 0.2f, 1.0f));
-					ImGui::Text("Error at line %d:", errorIt->first);
-					ImGui::PopStyleColor();
-					ImGui::Separator();
-					ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 1.0f, 0.2f, 1.0f));
-					ImGui::Text("%s", errorIt->second.c_str());
-					ImGui::PopStyleColor();
-					ImGui::EndTooltip();
-				}
-			}
+			// Draw diagnostics
+			if (!mDiagnosticLines.empty())
+				DrawDiagnostics(lineNo, start, textScreenPos, lineStartScreenPos.x + contentSize.x + 2.0f * scrollX);
 
 			// Draw line number (right aligned)
 			snprintf(buf, 16, "%d  ", lineNo + 1);
 
-			auto lineNoWidth = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf, nullptr, nullptr).x;
+			auto lineNoWidth = GetAsciiTextWidth(buf);
 			drawList->AddText(ImVec2(lineStartScreenPos.x + mTextStart - lineNoWidth, lineStartScreenPos.y), mPalette[(int)PaletteIndex::LineNumber], buf);
 
 			if (mState.mCursorPosition.mLine == lineNo)
@@ -982,23 +1152,14 @@ void TextEditor::Render()
 					{
 						float width = 1.0f;
 						auto cindex = GetCharacterIndex(mState.mCursorPosition);
-						float cx = TextDistanceToLineStart(mState.mCursorPosition);
+						float cx = GetLineX(lineNo, cindex);
 
 						if (mOverwrite && cindex < (int)line.size())
 						{
-							auto c = line[cindex].mChar;
-							if (c == '\t')
-							{
-								auto x = (1.0f + std::floor((1.0f + cx) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-								width = x - cx;
-							}
+							if (line.mChars[cindex] == '\t')
+								width = GetNextTabStop(cx) - cx;
 							else
-							{
-								char buf2[2];
-								buf2[0] = line[cindex].mChar;
-								buf2[1] = '\0';
-								width = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, buf2).x;
-							}
+								width = GetLineX(lineNo, cindex + UTF8CharLength(line.mChars[cindex])) - cx;
 						}
 						ImVec2 cstart(textScreenPos.x + cx, lineStartScreenPos.y);
 						ImVec2 cend(textScreenPos.x + cx + width, lineStartScreenPos.y + mCharAdvance.y);
@@ -1009,37 +1170,43 @@ void TextEditor::Render()
 				}
 			}
 
-			// Render colorized text
-			auto prevColor = line.empty() ? mPalette[(int)PaletteIndex::Default] : GetGlyphColor(line[0]);
-			ImVec2 bufferOffset;
-
-			for (int i = 0; i < line.size();)
+			// Render colorized text, only the part within the window. Runs of one color go out in one
+			// AddText straight from mChars, spaces join whatever run they are in.
+			const char* chars = line.mChars.data();
+			const int lineSize = (int)line.size();
+			const float clipMax = drawList->GetClipRectMax().x - textScreenPos.x;
+			int i = GetLineIndexAtX(lineNo, drawList->GetClipRectMin().x - textScreenPos.x);
+			float x = GetLineX(lineNo, i);
+			int runStart = -1;
+			float runX = 0.0f;
+			ImU32 runColor = 0;
+			auto flushRun = [&]()
 			{
-				auto& glyph = line[i];
-				auto color = GetGlyphColor(glyph);
+				if (runStart >= 0)
+					drawList->AddText(ImVec2(textScreenPos.x + runX, textScreenPos.y), runColor, chars + runStart, chars + i);
+				runStart = -1;
+			};
 
-				if ((color != prevColor || glyph.mChar == '\t' || glyph.mChar == ' ') && !mLineBuffer.empty())
-				{
-					const ImVec2 newOffset(textScreenPos.x + bufferOffset.x, textScreenPos.y + bufferOffset.y);
-					drawList->AddText(newOffset, prevColor, mLineBuffer.c_str());
-					auto textSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, mLineBuffer.c_str(), nullptr, nullptr);
-					bufferOffset.x += textSize.x;
-					mLineBuffer.clear();
-				}
-				prevColor = color;
+			while (i < lineSize && x <= clipMax)
+			{
+				const char c = chars[i];
+				const int next = c == '\t' ? i + 1 : std::min(lineSize, i + UTF8CharLength(c));
+				float nextX;
+				if (!line.mLayout.empty())
+					nextX = line.mLayout[next];
+				else
+					nextX = x + spaceSize;
 
-				if (glyph.mChar == '\t')
+				if (c == '\t')
 				{
-					auto oldX = bufferOffset.x;
-					bufferOffset.x = (1.0f + std::floor((1.0f + bufferOffset.x) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-					++i;
+					flushRun();
 
 					if (mShowWhitespaces)
 					{
 						const auto s = ImGui::GetFontSize();
-						const auto x1 = textScreenPos.x + oldX + 1.0f;
-						const auto x2 = textScreenPos.x + bufferOffset.x - 1.0f;
-						const auto y = textScreenPos.y + bufferOffset.y + s * 0.5f;
+						const auto x1 = textScreenPos.x + x + 1.0f;
+						const auto x2 = textScreenPos.x + nextX - 1.0f;
+						const auto y = textScreenPos.y + s * 0.5f;
 						const ImVec2 p1(x1, y);
 						const ImVec2 p2(x2, y);
 						const ImVec2 p3(x2 - s * 0.2f, y - s * 0.2f);
@@ -1049,33 +1216,32 @@ void TextEditor::Render()
 						drawList->AddLine(p2, p4, 0x90909090);
 					}
 				}
-				else if (glyph.mChar == ' ')
+				else if (c == ' ')
 				{
 					if (mShowWhitespaces)
 					{
 						const auto s = ImGui::GetFontSize();
-						const auto x = textScreenPos.x + bufferOffset.x + spaceSize * 0.5f;
-						const auto y = textScreenPos.y + bufferOffset.y + s * 0.5f;
-						drawList->AddCircleFilled(ImVec2(x, y), 1.5f, 0x80808080, 4);
+						const auto y = textScreenPos.y + s * 0.5f;
+						drawList->AddCircleFilled(ImVec2(textScreenPos.x + x + spaceSize * 0.5f, y), 1.5f, 0x80808080, 4);
 					}
-					bufferOffset.x += spaceSize;
-					i++;
 				}
 				else
 				{
-					auto l = UTF8CharLength(glyph.mChar);
-					while (l-- > 0)
-						mLineBuffer.push_back(line[i++].mChar);
+					auto color = GetGlyphColor(line[i]);
+					if (runStart >= 0 && color != runColor)
+						flushRun();
+					if (runStart < 0)
+					{
+						runStart = i;
+						runX = x;
+						runColor = color;
+					}
 				}
-				++columnNo;
-			}
 
-			if (!mLineBuffer.empty())
-			{
-				const ImVec2 newOffset(textScreenPos.x + bufferOffset.x, textScreenPos.y + bufferOffset.y);
-				drawList->AddText(newOffset, prevColor, mLineBuffer.c_str());
-				mLineBuffer.clear();
+				i = next;
+				x = nextX;
 			}
+			flushRun();
 
 			++lineNo;
 		}
@@ -1131,6 +1297,9 @@ void TextEditor::Render(const char* aTitle, bool* p_open)
 		ImGui::Begin(aTitle, p_open, ImGuiWindowFlags_HorizontalScrollbar);
 	}
 
+	UpdateLayoutMetrics();
+	UpdateDiagnostics();
+
 	if (mHandleKeyboardInputs)
 	{
 		HandleKeyboardInputs();
@@ -1140,7 +1309,9 @@ void TextEditor::Render(const char* aTitle, bool* p_open)
 	if (mHandleMouseInputs)
 		HandleMouseInputs();
 
+	auto colorizeStart = std::chrono::steady_clock::now();
 	ColorizeInternal();
+	mColorizeMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - colorizeStart).count();
 	Render();
 
 	if (mHandleKeyboardInputs)
@@ -1169,7 +1340,7 @@ void TextEditor::SetText(const std::string& aText)
 			mLines.emplace_back(Line());
 		else
 		{
-			mLines.back().emplace_back(Glyph(chr, PaletteIndex::Default));
+			mLines.back().push_back(Glyph(chr, PaletteIndex::Default));
 		}
 	}
 
@@ -1177,7 +1348,9 @@ void TextEditor::SetText(const std::string& aText)
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
+	mUndoText.clear();
 	mUndoIndex = 0;
+	mLineStates.clear();
 
 	Colorize();
 }
@@ -1196,11 +1369,8 @@ void TextEditor::SetTextLines(const std::vector<std::string>& aLines)
 
 		for (size_t i = 0; i < aLines.size(); ++i)
 		{
-			const std::string& aLine = aLines[i];
-
-			mLines[i].reserve(aLine.size());
-			for (size_t j = 0; j < aLine.size(); ++j)
-				mLines[i].emplace_back(Glyph(aLine[j], PaletteIndex::Default));
+			mLines[i].mChars = aLines[i];
+			mLines[i].mAttributes.assign(aLines[i].size(), (uint8_t)PaletteIndex::Default);
 		}
 	}
 
@@ -1208,7 +1378,9 @@ void TextEditor::SetTextLines(const std::vector<std::string>& aLines)
 	mScrollToTop = true;
 
 	mUndoBuffer.clear();
+	mUndoText.clear();
 	mUndoIndex = 0;
+	mLineStates.clear();
 
 	Colorize();
 }
@@ -1256,16 +1428,16 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				{
 					if (!line.empty())
 					{
-						if (line.front().mChar == '\t')
+						if (line[0].mChar == '\t')
 						{
-							line.erase(line.begin());
+							line.erase(0, 1);
 							modified = true;
 						}
 						else
 						{
-							for (int j = 0; j < mTabSize && !line.empty() && line.front().mChar == ' '; j++)
+							for (int j = 0; j < mTabSize && !line.empty() && line[0].mChar == ' '; j++)
 							{
-								line.erase(line.begin());
+								line.erase(0, 1);
 								modified = true;
 							}
 						}
@@ -1273,7 +1445,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				}
 				else
 				{
-					line.insert(line.begin(), Glyph('\t', TextEditor::PaletteIndex::Background));
+					line.insert(0, Glyph('\t', TextEditor::PaletteIndex::Background));
 					modified = true;
 				}
 			}
@@ -1304,6 +1476,7 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				AddUndo(u);
 
 				mTextChanged = true;
+				CheckComments(start.mLine, end.mLine + 1);
 
 				EnsureCursorVisible();
 			}
@@ -1336,8 +1509,8 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 
 		const size_t whitespaceSize = newLine.size();
 		auto cindex = GetCharacterIndex(coord);
-		newLine.insert(newLine.end(), line.begin() + cindex, line.end());
-		line.erase(line.begin() + cindex, line.begin() + line.size());
+		newLine.insert(newLine.size(), line, cindex, line.size());
+		line.erase(cindex, line.size());
 		SetCursorPosition(Coordinates(coord.mLine + 1, GetCharacterColumn(coord.mLine + 1, (int)whitespaceSize)));
 		u.mAdded = (char)aChar;
 	}
@@ -1361,12 +1534,12 @@ void TextEditor::EnterCharacter(ImWchar aChar, bool aShift)
 				while (d-- > 0 && cindex < (int)line.size())
 				{
 					u.mRemoved += line[cindex].mChar;
-					line.erase(line.begin() + cindex);
+					line.erase(cindex, cindex + 1);
 				}
 			}
 
 			for (auto p = buf; *p != '\0'; p++, ++cindex)
-				line.insert(line.begin() + cindex, Glyph(*p, PaletteIndex::Default));
+				line.insert(cindex, Glyph(*p, PaletteIndex::Default));
 			u.mAdded = buf;
 
 			SetCursorPosition(Coordinates(coord.mLine, GetCharacterColumn(coord.mLine, cindex)));
@@ -1791,7 +1964,7 @@ void TextEditor::Delete()
 			Advance(u.mRemovedEnd);
 
 			auto& nextLine = mLines[pos.mLine + 1];
-			line.insert(line.end(), nextLine.begin(), nextLine.end());
+			line.insert(line.size(), nextLine, 0, nextLine.size());
 			RemoveLine(pos.mLine + 1);
 		}
 		else
@@ -1803,7 +1976,7 @@ void TextEditor::Delete()
 
 			auto d = UTF8CharLength(line[cindex].mChar);
 			while (d-- > 0 && cindex < (int)line.size())
-				line.erase(line.begin() + cindex);
+				line.erase(cindex, cindex + 1);
 		}
 
 		mTextChanged = true;
@@ -1850,12 +2023,12 @@ void TextEditor::Backspace()
 			auto& line = mLines[mState.mCursorPosition.mLine];
 			auto& prevLine = mLines[mState.mCursorPosition.mLine - 1];
 			auto prevSize = GetLineMaxColumn(mState.mCursorPosition.mLine - 1);
-			prevLine.insert(prevLine.end(), line.begin(), line.end());
+			prevLine.insert(prevLine.size(), line, 0, line.size());
 
-			ErrorMarkers etmp;
-			for (auto& i : mErrorMarkers)
-				etmp.insert(ErrorMarkers::value_type(i.first - 1 == mState.mCursorPosition.mLine ? i.first - 1 : i.first, i.second));
-			mErrorMarkers = std::move(etmp);
+			DiagnosticLines etmp;
+			for (auto& i : mDiagnosticLines)
+				etmp.insert(DiagnosticLines::value_type(i.first - 1 == mState.mCursorPosition.mLine ? i.first - 1 : i.first, i.second));
+			mDiagnosticLines = std::move(etmp);
 
 			RemoveLine(mState.mCursorPosition.mLine);
 			--mState.mCursorPosition.mLine;
@@ -1879,7 +2052,7 @@ void TextEditor::Backspace()
 			while (cindex < line.size() && cend-- > cindex)
 			{
 				u.mRemoved += line[cindex].mChar;
-				line.erase(line.begin() + cindex);
+				line.erase(cindex, cindex + 1);
 			}
 		}
 
@@ -1919,11 +2092,8 @@ void TextEditor::Copy()
 	{
 		if (!mLines.empty())
 		{
-			std::string str;
 			auto& line = mLines[GetActualCursorCoordinates().mLine];
-			for (auto& g : line)
-				str.push_back(g.mChar);
-			ImGui::SetClipboardText(str.c_str());
+			ImGui::SetClipboardText(line.mChars.c_str());
 		}
 	}
 }
@@ -2024,6 +2194,7 @@ const TextEditor::Palette& TextEditor::GetDarkPalette()
 			0xffe0e0e0, // Cursor
 			0x80a06020, // Selection
 			0x800020ff, // ErrorMarker
+			0x8000c0ff, // WarningMarker
 			0x40f08000, // Breakpoint
 			0xff707000, // Line number
 			0x40000000, // Current line fill
@@ -2052,6 +2223,7 @@ const TextEditor::Palette& TextEditor::GetLightPalette()
 			0xff000000, // Cursor
 			0x80600000, // Selection
 			0xa00010ff, // ErrorMarker
+			0xa000b0ff, // WarningMarker
 			0x80f08000, // Breakpoint
 			0xff505000, // Line number
 			0x40000000, // Current line fill
@@ -2080,6 +2252,7 @@ const TextEditor::Palette& TextEditor::GetRetroBluePalette()
 			0xff0080ff, // Cursor
 			0x80ffff00, // Selection
 			0xa00000ff, // ErrorMarker
+			0xa000a0ff, // WarningMarker
 			0x80ff8000, // Breakpoint
 			0xff808000, // Line number
 			0x40000000, // Current line fill
@@ -2095,6 +2268,16 @@ std::string TextEditor::GetText() const
 	return GetText(Coordinates(), Coordinates((int)mLines.size(), 0));
 }
 
+void TextEditor::GetText(std::string& aText) const
+{
+	aText.clear();
+	for (auto& line : mLines)
+	{
+		aText.append(line.mChars);
+		aText += '\n';
+	}
+}
+
 std::vector<std::string> TextEditor::GetTextLines() const
 {
 	std::vector<std::string> result;
@@ -2102,16 +2285,7 @@ std::vector<std::string> TextEditor::GetTextLines() const
 	result.reserve(mLines.size());
 
 	for (auto& line : mLines)
-	{
-		std::string text;
-
-		text.resize(line.size());
-
-		for (size_t i = 0; i < line.size(); ++i)
-			text[i] = line[i].mChar;
-
-		result.emplace_back(std::move(text));
-	}
+		result.emplace_back(line.mChars);
 
 	return result;
 }
@@ -2140,7 +2314,16 @@ void TextEditor::Colorize(int aFromLine, int aLines)
 	mColorRangeMax = std::max(mColorRangeMax, toLine);
 	mColorRangeMin = std::max(0, mColorRangeMin);
 	mColorRangeMax = std::max(mColorRangeMin, mColorRangeMax);
+	CheckComments(std::max(0, aFromLine), aLines == -1 ? std::numeric_limits<int>::max() : toLine);
+}
+
+void TextEditor::CheckComments(int aFromLine, int aToLine)
+{
+	mCheckCommentsMin = mCheckComments ? std::min(mCheckCommentsMin, aFromLine) : aFromLine;
+	mCheckCommentsMax = mCheckComments ? std::max(mCheckCommentsMax, aToLine) : aToLine;
 	mCheckComments = true;
+	// every edit ends up here, so colors computed before it are stale
+	++mTextVersion;
 }
 
 void TextEditor::ColorizeRange(int aFromLine, int aToLine)
@@ -2148,7 +2331,8 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 	if (mLines.empty() || aFromLine >= aToLine)
 		return;
 
-	std::string buffer;
+	TRACE_ZONE("ColorizeRange");
+
 	std::cmatch results;
 	std::string id;
 
@@ -2156,94 +2340,101 @@ void TextEditor::ColorizeRange(int aFromLine, int aToLine)
 	for (int i = aFromLine; i < endLine; ++i)
 	{
 		auto& line = mLines[i];
+		ColorizeLine(line.mChars.data(), line.mAttributes.data(), (int)line.size(), results, id);
+	}
+}
 
-		if (line.empty())
-			continue;
+// Runs on the colorize thread as well, must not touch anything but the given line and the
+// language definition
+void TextEditor::ColorizeLine(const char* aChars, uint8_t* aAttributes, int aSize, std::cmatch& aResults, std::string& aId) const
+{
+	// the tokenizers read the characters in place, only the colors are written
+	for (int i = 0; i < aSize; ++i)
+		aAttributes[i] &= ~Line::ColorMask;
 
-		buffer.resize(line.size());
-		for (size_t j = 0; j < line.size(); ++j)
-		{
-			auto& col = line[j];
-			buffer[j] = col.mChar;
-			col.mColorIndex = PaletteIndex::Default;
-		}
+	const char* bufferBegin = aChars;
+	const char* bufferEnd = bufferBegin + aSize;
 
-		const char* bufferBegin = &buffer.front();
-		const char* bufferEnd = bufferBegin + buffer.size();
+	auto last = bufferEnd;
 
-		auto last = bufferEnd;
+	for (auto first = bufferBegin; first != last; )
+	{
+		const char* token_begin = nullptr;
+		const char* token_end = nullptr;
+		PaletteIndex token_color = PaletteIndex::Default;
 
-		for (auto first = bufferBegin; first != last; )
-		{
-			const char* token_begin = nullptr;
-			const char* token_end = nullptr;
-			PaletteIndex token_color = PaletteIndex::Default;
+		bool hasTokenizeResult = false;
 
-			bool hasTokenizeResult = false;
+		if (mLanguageDefinition.mTokenize != nullptr)
+		{
+			if (mLanguageDefinition.mTokenize(first, last, token_begin, token_end, token_color))
+				hasTokenizeResult = true;
+		}
 
-			if (mLanguageDefinition.mTokenize != nullptr)
-			{
-				if (mLanguageDefinition.mTokenize(first, last, token_begin, token_end, token_color))
-					hasTokenizeResult = true;
-			}
+		if (hasTokenizeResult == false)
+		{
+			// todo : remove
+			//printf("using regex for %.*s\n", first + 10 < last ? 10 : int(last - first), first);
 
-			if (hasTokenizeResult == false)
+			for (auto& p : mRegexList)
 			{
-				// todo : remove
-				//printf("using regex for %.*s\n", first + 10 < last ? 10 : int(last - first), first);
-
-				for (auto& p : mRegexList)
+				if (std::regex_search(first, last, aResults, p.first, std::regex_constants::match_continuous))
 				{
-					if (std::regex_search(first, last, results, p.first, std::regex_constants::match_continuous))
-					{
-						hasTokenizeResult = true;
+					hasTokenizeResult = true;
 
-						auto& v = *results.begin();
-						token_begin = v.first;
-						token_end = v.second;
-						token_color = p.second;
-						break;
-					}
+					auto& v = *aResults.begin();
+					token_begin = v.first;
+					token_end = v.second;
+					token_color = p.second;
+					break;
 				}
 			}
+		}
+
+		if (hasTokenizeResult == false)
+		{
+			first++;
+		}
+		else
+		{
+			const size_t token_length = token_end - token_begin;
 
-			if (hasTokenizeResult == false)
+			const bool preprocessor = (aAttributes[first - bufferBegin] & Line::PreprocessorFlag) != 0;
+			if (token_color == PaletteIndex::Identifier && !preprocessor && mLanguageDefinition.mClassifyIdentifier != nullptr)
 			{
-				first++;
+				mLanguageDefinition.mClassifyIdentifier(token_begin, token_end, token_color);
 			}
-			else
+			else if (token_color == PaletteIndex::Identifier && (!preprocessor || !mLanguageDefinition.mPreprocIdentifiers.empty()))
 			{
-				const size_t token_length = token_end - token_begin;
-
-				if (token_color == PaletteIndex::Identifier)
-				{
-					id.assign(token_begin, token_end);
+				aId.assign(token_begin, token_end);
 
-					// todo : allmost all language definitions use lower case to specify keywords, so shouldn't this use ::tolower ?
-					if (!mLanguageDefinition.mCaseSensitive)
-						std::transform(id.begin(), id.end(), id.begin(), ::toupper);
+				// todo : allmost all language definitions use lower case to specify keywords, so shouldn't this use ::tolower ?
+				if (!mLanguageDefinition.mCaseSensitive)
+					std::transform(aId.begin(), aId.end(), aId.begin(), ::toupper);
 
-					if (!line[first - bufferBegin].mPreprocessor)
-					{
-						if (mLanguageDefinition.mKeywords.count(id) != 0)
-							token_color = PaletteIndex::Keyword;
-						else if (mLanguageDefinition.mIdentifiers.count(id) != 0)
-							token_color = PaletteIndex::KnownIdentifier;
-						else if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
-							token_color = PaletteIndex::PreprocIdentifier;
-					}
-					else
-					{
-						if (mLanguageDefinition.mPreprocIdentifiers.count(id) != 0)
-							token_color = PaletteIndex::PreprocIdentifier;
-					}
+				if (!preprocessor)
+				{
+					if (mLanguageDefinition.mKeywords.count(aId) != 0)
+						token_color = PaletteIndex::Keyword;
+					else if (mLanguageDefinition.mIdentifiers.count(aId) != 0)
+						token_color = PaletteIndex::KnownIdentifier;
+					else if (mLanguageDefinition.mPreprocIdentifiers.count(aId) != 0)
+						token_color = PaletteIndex::PreprocIdentifier;
 				}
+				else
+				{
+					if (mLanguageDefinition.mPreprocIdentifiers.count(aId) != 0)
+						token_color = PaletteIndex::PreprocIdentifier;
+				}
+			}
 
-				for (size_t j = 0; j < token_length; ++j)
-					line[(token_begin - bufferBegin) + j].mColorIndex = token_color;
-
-				first = token_end;
+			for (size_t j = 0; j < token_length; ++j)
+			{
+				auto& attributes = aAttributes[(token_begin - bufferBegin) + j];
+				attributes = (attributes & ~Line::ColorMask) | (uint8_t)token_color;
 			}
+
+			first = token_end;
 		}
 	}
 }
@@ -2253,171 +2444,476 @@ void TextEditor::ColorizeInternal()
 	if (mLines.empty() || !mColorizerEnabled)
 		return;
 
+	TRACE_ZONE("ColorizeInternal");
+
 	if (mCheckComments)
 	{
-		auto endLine = mLines.size();
-		auto endIndex = 0;
-		auto commentStartLine = endLine;
-		auto commentStartIndex = endIndex;
-		auto withinString = false;
-		auto withinSingleLineComment = false;
-		auto withinPreproc = false;
-		auto firstChar = true;			// there is no other non-whitespace characters in the line before
-		auto concatenate = false;		// '\' on the very end of the line
-		auto currentLine = 0;
-		auto currentIndex = 0;
-		while (currentLine < endLine || currentIndex < endIndex)
+		// Only the edited lines are rescanned, then it keeps going until a line starts in the
+		// same state as last time, everything after that cannot have changed
+		auto lineCount = (int)mLines.size();
+		auto fromLine = std::min(mCheckCommentsMin, lineCount - 1);
+		if (mLineStates.size() != mLines.size() + 1)
 		{
-			auto& line = mLines[currentLine];
+			mLineStates.assign(mLines.size() + 1, LineState());
+			fromLine = 0;
+			mCheckCommentsMax = lineCount;
+		}
 
-			if (currentIndex == 0 && !concatenate)
+		auto state = mLineStates[fromLine];
+		auto pred = [](const char& a, const char& b) { return a == b; };
+		auto& startStr = mLanguageDefinition.mCommentStart;
+		auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
+		auto& endStr = mLanguageDefinition.mCommentEnd;
+		auto toLine = fromLine;
+		for (auto currentLine = fromLine; currentLine < lineCount; ++currentLine)
+		{
+			if (currentLine >= mCheckCommentsMax && mLineStates[currentLine] == state)
+				break;
+			mLineStates[currentLine] = state;
+			toLine = currentLine + 1;
+
+			auto& line = mLines[currentLine];
+			if (!state.mConcatenate)
 			{
-				withinSingleLineComment = false;
-				withinPreproc = false;
-				firstChar = true;
+				state.mWithinSingleLineComment = false;
+				state.mWithinPreproc = false;
+				state.mFirstChar = true;
 			}
 
-			concatenate = false;
+			// an empty line ends a '\' continuation
+			state.mConcatenate = false;
 
-			if (!line.empty())
+			auto currentIndex = 0;
+			while (currentIndex < (int)line.size())
 			{
-				auto& g = line[currentIndex];
-				auto c = g.mChar;
+				auto c = (Char)line.mChars[currentIndex];
 
 				if (c != mLanguageDefinition.mPreprocChar && !isspace(c))
-					firstChar = false;
+					state.mFirstChar = false;
 
-				if (currentIndex == (int)line.size() - 1 && line[line.size() - 1].mChar == '\\')
-					concatenate = true;
+				state.mConcatenate = currentIndex == (int)line.size() - 1 && c == '\\';
 
-				bool inComment = (commentStartLine < currentLine || (commentStartLine == currentLine && commentStartIndex <= currentIndex));
+				bool inComment = state.mWithinComment;
 
-				if (withinString)
+				if (state.mWithinString)
 				{
-					line[currentIndex].mMultiLineComment = inComment;
+					line.SetFlag(currentIndex, Line::MultiLineCommentFlag, inComment);
 
 					if (c == '\"')
 					{
-						if (currentIndex + 1 < (int)line.size() && line[currentIndex + 1].mChar == '\"')
+						if (currentIndex + 1 < (int)line.size() && line.mChars[currentIndex + 1] == '\"')
 						{
 							currentIndex += 1;
 							if (currentIndex < (int)line.size())
-								line[currentIndex].mMultiLineComment = inComment;
+								line.SetFlag(currentIndex, Line::MultiLineCommentFlag, inComment);
 						}
 						else
-							withinString = false;
+							state.mWithinString = false;
 					}
 					else if (c == '\\')
 					{
 						currentIndex += 1;
 						if (currentIndex < (int)line.size())
-							line[currentIndex].mMultiLineComment = inComment;
+							line.SetFlag(currentIndex, Line::MultiLineCommentFlag, inComment);
 					}
 				}
 				else
 				{
-					if (firstChar && c == mLanguageDefinition.mPreprocChar)
-						withinPreproc = true;
+					if (state.mFirstChar && c == mLanguageDefinition.mPreprocChar)
+						state.mWithinPreproc = true;
 
 					if (c == '\"')
 					{
-						withinString = true;
-						line[currentIndex].mMultiLineComment = inComment;
+						state.mWithinString = true;
+						line.SetFlag(currentIndex, Line::MultiLineCommentFlag, inComment);
 					}
 					else
 					{
-						auto pred = [](const char& a, const Glyph& b) { return a == b.mChar; };
-						auto from = line.begin() + currentIndex;
-						auto& startStr = mLanguageDefinition.mCommentStart;
-						auto& singleStartStr = mLanguageDefinition.mSingleLineComment;
+						auto from = line.mChars.begin() + currentIndex;
 
 						if (singleStartStr.size() > 0 &&
 							currentIndex + singleStartStr.size() <= line.size() &&
 							equals(singleStartStr.begin(), singleStartStr.end(), from, from + singleStartStr.size(), pred))
 						{
-							withinSingleLineComment = true;
+							state.mWithinSingleLineComment = true;
 						}
-						else if (!withinSingleLineComment && currentIndex + startStr.size() <= line.size() &&
+						else if (!state.mWithinSingleLineComment && currentIndex + startStr.size() <= line.size() &&
 							equals(startStr.begin(), startStr.end(), from, from + startStr.size(), pred))
 						{
-							commentStartLine = currentLine;
-							commentStartIndex = currentIndex;
+							state.mWithinComment = true;
 						}
 
-						inComment = inComment = (commentStartLine < currentLine || (commentStartLine == currentLine && commentStartIndex <= currentIndex));
+						inComment = state.mWithinComment;
 
-						line[currentIndex].mMultiLineComment = inComment;
-						line[currentIndex].mComment = withinSingleLineComment;
+						line.SetFlag(currentIndex, Line::MultiLineCommentFlag, inComment);
+						line.SetFlag(currentIndex, Line::CommentFlag, state.mWithinSingleLineComment);
 
-						auto& endStr = mLanguageDefinition.mCommentEnd;
 						if (currentIndex + 1 >= (int)endStr.size() &&
 							equals(endStr.begin(), endStr.end(), from + 1 - endStr.size(), from + 1, pred))
 						{
-							commentStartIndex = endIndex;
-							commentStartLine = endLine;
+							state.mWithinComment = false;
 						}
 					}
 				}
-				line[currentIndex].mPreprocessor = withinPreproc;
+				if (currentIndex < (int)line.size())
+					line.SetFlag(currentIndex, Line::PreprocessorFlag, state.mWithinPreproc);
 				currentIndex += UTF8CharLength(c);
-				if (currentIndex >= (int)line.size())
-				{
-					currentIndex = 0;
-					++currentLine;
-				}
 			}
-			else
+
+			if (currentLine + 1 == lineCount)
+				mLineStates[lineCount] = state;
+		}
+		mCheckComments = false;
+
+		// identifiers are colored differently within a preprocessor line, so a rescanned line may
+		// need new colors even if it was not edited
+		mColorRangeMin = std::min(mColorRangeMin, fromLine);
+		mColorRangeMax = std::max(mColorRangeMax, toLine);
+	}
+
+	ApplyColorizeResults();
+
+	// one round in flight at a time, an edit made meanwhile waits for it and then posts again
+	if (mColorRangeMin < mColorRangeMax && mColorizePending == 0)
+		PostColorizeJobs();
+}
+
+void TextEditor::AddColorizeJobLine(ColorizeJob& aJob, int aIndex) const
+{
+	auto& line = mLines[aIndex];
+	aJob.mLineIndices.push_back(aIndex);
+	aJob.mLineStarts.push_back((int)aJob.mChars.size());
+	aJob.mChars.append(line.mChars);
+	aJob.mAttributes.insert(aJob.mAttributes.end(), line.mAttributes.begin(), line.mAttributes.end());
+}
+
+void TextEditor::PostColorizeJobs()
+{
+	TRACE_ZONE("PostColorizeJobs");
+
+	if (!mColorizeThread.joinable())
+		mColorizeThread = std::thread(&TextEditor::ColorizeWorker, this);
+
+	const int lineCount = (int)mLines.size();
+	const int increment = (mLanguageDefinition.mTokenize == nullptr) ? 10 : 10000;
+	const int rangeMax = std::min(mColorRangeMax, lineCount);
+
+	// the lines on screen go first, so what the user looks at never waits for a large document
+	ColorizeJob visible;
+	visible.mVersion = mTextVersion;
+	for (int i = std::max(mVisibleLineMin, mColorRangeMin); i < std::min(mVisibleLineMax, rangeMax); ++i)
+		AddColorizeJobLine(visible, i);
+
+	ColorizeJob range;
+	range.mVersion = mTextVersion;
+	range.mRangeBegin = mColorRangeMin;
+	range.mRangeEnd = std::min(mColorRangeMin + increment, rangeMax);
+	for (int i = mColorRangeMin; i < range.mRangeEnd; ++i)
+		AddColorizeJobLine(range, i);
+
+	std::lock_guard<std::mutex> lock(mColorizeMutex);
+	if (!visible.mLineIndices.empty())
+	{
+		mColorizeRequests.push_back(std::move(visible));
+		mColorizePending++;
+	}
+	mColorizeRequests.push_back(std::move(range));
+	mColorizePending++;
+	mColorizeWake.notify_one();
+}
+
+// Same characters and comment flags, the colors do not depend on anything else
+static bool IsSameLine(const TextEditor::Line& aLine, const char* aChars, const uint8_t* aAttributes, int aSize)
+{
+	if ((int)aLine.size() != aSize || memcmp(aLine.mChars.data(), aChars, aSize) != 0)
+		return false;
+	for (int i = 0; i < aSize; ++i)
+		if ((aLine.mAttributes[i] ^ aAttributes[i]) & ~TextEditor::Line::ColorMask)
+			return false;
+	return true;
+}
+
+void TextEditor::ApplyColorizeResults()
+{
+	if (mColorizePending == 0)
+		return;
+
+	ColorizeJobs results;
+	{
+		std::lock_guard<std::mutex> lock(mColorizeMutex);
+		results.swap(mColorizeResults);
+	}
+
+	for (auto& job : results)
+	{
+		mColorizePending--;
+
+		// After an edit only the lines that still read the same are taken, so typing does not
+		// keep throwing away the colors of the rest of the document. The range only moves up to
+		// the first line that changed, and not at all if an edit moved its start.
+		bool sameVersion = job.mVersion == mTextVersion;
+		int colored = job.mRangeEnd;
+		for (size_t i = 0; i < job.mLineIndices.size(); ++i)
+		{
+			int index = job.mLineIndices[i];
+			int start = job.mLineStarts[i];
+			int size = job.GetLineSize(i);
+			if (sameVersion || (index < (int)mLines.size() && IsSameLine(mLines[index], job.mChars.data() + start, job.mAttributes.data() + start, size)))
+				std::copy_n(job.mAttributes.begin() + start, size, mLines[index].mAttributes.begin());
+			else if (colored > index)
+				colored = index;
+		}
+
+		if (colored >= 0 && mColorRangeMin == job.mRangeBegin)
+		{
+			mColorRangeMin = colored;
+			if (mColorRangeMin >= std::min(mColorRangeMax, (int)mLines.size()))
 			{
-				currentIndex = 0;
-				++currentLine;
+				mColorRangeMin = std::numeric_limits<int>::max();
+				mColorRangeMax = 0;
 			}
 		}
-		mCheckComments = false;
 	}
+}
+
+void TextEditor::ColorizeWorker()
+{
+	SetTraceThreadName("Colorizer");
 
-	if (mColorRangeMin < mColorRangeMax)
+	std::cmatch results;
+	std::string id;
+
+	std::unique_lock<std::mutex> lock(mColorizeMutex);
+	for (;;)
 	{
-		const int increment = (mLanguageDefinition.mTokenize == nullptr) ? 10 : 10000;
-		const int to = std::min(mColorRangeMin + increment, mColorRangeMax);
-		ColorizeRange(mColorRangeMin, to);
-		mColorRangeMin = to;
+		mColorizeWake.wait(lock, [this] { return mColorizeQuit || !mColorizeRequests.empty(); });
+		if (mColorizeQuit)
+			break;
+
+		ColorizeJob job = std::move(mColorizeRequests.front());
+		mColorizeRequests.erase(mColorizeRequests.begin());
+		lock.unlock();
 
-		if (mColorRangeMax == mColorRangeMin)
 		{
-			mColorRangeMin = std::numeric_limits<int>::max();
-			mColorRangeMax = 0;
+			TRACE_ZONE("Colorize Job");
+			for (size_t i = 0; i < job.mLineIndices.size(); ++i)
+			{
+				int start = job.mLineStarts[i];
+				ColorizeLine(job.mChars.data() + start, job.mAttributes.data() + start, job.GetLineSize(i), results, id);
+			}
 		}
-		return;
+
+		lock.lock();
+		mColorizeResults.push_back(std::move(job));
+		if (mColorizeNotify)
+			mColorizeNotify();
+	}
+}
+
+void TextEditor::StopColorizeWorker()
+{
+	if (mColorizeThread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mColorizeMutex);
+			mColorizeQuit = true;
+		}
+		mColorizeWake.notify_one();
+		mColorizeThread.join();
 	}
+
+	mColorizeQuit = false;
+	mColorizeRequests.clear();
+	mColorizeResults.clear();
+	mColorizePending = 0;
 }
 
 float TextEditor::TextDistanceToLineStart(const Coordinates& aFrom) const
 {
-	auto& line = mLines[aFrom.mLine];
-	float distance = 0.0f;
-	float spaceSize = ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, " ", nullptr, nullptr).x;
-	int colIndex = GetCharacterIndex(aFrom);
-	for (size_t it = 0u; it < line.size() && it < colIndex; )
+	return GetLineX(aFrom.mLine, GetCharacterIndex(aFrom));
+}
+
+void TextEditor::UpdateDiagnostics()
+{
+	uint32_t version = mDiagnostics ? mDiagnostics->mVersion : 0;
+	if (version == mDiagnosticsVersion)
+		return;
+	mDiagnosticsVersion = version;
+
+	mDiagnosticLines.clear();
+	for (int i = 0; i < (int)mDiagnostics->mEntries.size(); i++)
+		if (mDiagnostics->mEntries[i].mLine > 0)
+			mDiagnosticLines.insert(DiagnosticLines::value_type(mDiagnostics->mEntries[i].mLine, i));
+}
+
+// Line fill, squiggles and tooltip for the diagnostics on one line
+void TextEditor::DrawDiagnostics(int aLineNo, const ImVec2& aLineStart, const ImVec2& aTextStart, float aLineEndX)
+{
+	auto range = mDiagnosticLines.equal_range(aLineNo + 1);
+	if (range.first == range.second)
+		return;
+
+	bool hasError = false;
+	for (auto it = range.first; it != range.second; ++it)
+		hasError |= mDiagnostics->mEntries[it->second].mSeverity == DiagnosticSeverity::Error;
+
+	auto drawList = ImGui::GetWindowDrawList();
+	auto end = ImVec2(aLineEndX, aLineStart.y + mCharAdvance.y);
+	drawList->AddRectFilled(aLineStart, end, mPalette[(int)(hasError ? PaletteIndex::ErrorMarker : PaletteIndex::WarningMarker)]);
+
+	// the columns come from the last compile, the text may have changed since
+	auto& line = mLines[aLineNo];
+	const int lineSize = (int)line.size();
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		auto& diagnostic = mDiagnostics->mEntries[it->second];
+		if (diagnostic.mStart < 0 || diagnostic.mStart >= lineSize)
+			continue;
+
+		int last = diagnostic.mEnd;
+		if (last < 0)
+		{
+			last = diagnostic.mStart + 1;
+			if (isalnum(line.mChars[diagnostic.mStart]) || line.mChars[diagnostic.mStart] == '_')
+				while (last < lineSize && (isalnum(line.mChars[last]) || line.mChars[last] == '_'))
+					last++;
+		}
+		last = std::min(last, lineSize);
+
+		auto severity = diagnostic.mSeverity == DiagnosticSeverity::Error ? PaletteIndex::ErrorMarker : PaletteIndex::WarningMarker;
+		auto color = mPalette[(int)severity] | IM_COL32_A_MASK;
+		float x0 = aTextStart.x + GetLineX(aLineNo, diagnostic.mStart);
+		float x1 = std::max(x0 + mSpaceSize, aTextStart.x + GetLineX(aLineNo, last));
+		float y = aLineStart.y + mCharAdvance.y - 2.0f;
+		const float step = 2.0f;
+		for (float x = x0; x < x1; x += step)
+			drawList->PathLineTo(ImVec2(x, ((int)((x - x0) / step) & 1) ? y - step * 0.75f : y));
+		drawList->PathLineTo(ImVec2(x1, y));
+		drawList->PathStroke(color, false, 1.0f);
+	}
+
+	if (ImGui::IsMouseHoveringRect(aLineStart, end))
+	{
+		ImGui::BeginTooltip();
+		ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.2f, 0.2f, 1.0f));
+		ImGui::Text("%s at line %d:", hasError ? "Error" : "Warning", aLineNo + 1);
+		ImGui::PopStyleColor();
+		ImGui::Separator();
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			auto& diagnostic = mDiagnostics->mEntries[it->second];
+			bool error = diagnostic.mSeverity == DiagnosticSeverity::Error;
+			ImGui::PushStyleColor(ImGuiCol_Text, error ? ImVec4(1.0f, 1.0f, 0.2f, 1.0f) : ImVec4(1.0f, 0.7f, 0.2f, 1.0f));
+			ImGui::Text("%s", diagnostic.mMessage.c_str());
+			ImGui::PopStyleColor();
+		}
+		ImGui::EndTooltip();
+	}
+}
+
+void TextEditor::UpdateLayoutMetrics()
+{
+	auto font = ImGui::GetFont();
+	const float fontSize = ImGui::GetFontSize();
+	if (font != mLayoutFont || fontSize != mLayoutFontSize || mTabSize != mLayoutTabSize)
 	{
-		if (line[it].mChar == '\t')
+		mLayoutFont = font;
+		mLayoutFontSize = fontSize;
+		mLayoutTabSize = mTabSize;
+		if (++mLayoutStamp == 0)
+			mLayoutStamp = 1;
+
+		// What ImFont::CalcTextSizeA adds up per character
+		const float scale = fontSize / font->FontSize;
+		for (int c = 0; c < 128; ++c)
+			mAsciiAdvance[c] = font->GetCharAdvance((ImWchar)c) * scale;
+		mSpaceSize = mAsciiAdvance[' '];
+		mMonospace = true;
+		for (int c = ' ' + 1; c < 127; ++c)
+			mMonospace = mMonospace && mAsciiAdvance[c] == mSpaceSize;
+	}
+
+	/* Compute mCharAdvance regarding to scaled font size (Ctrl + mouse wheel)*/
+	mCharAdvance = ImVec2(mAsciiAdvance['#'], ImGui::GetTextLineHeightWithSpacing() * mLineSpacing);
+}
+
+void TextEditor::UpdateLineLayout(const Line& aLine) const
+{
+	if (aLine.mLayoutStamp == mLayoutStamp)
+		return;
+	aLine.mLayoutStamp = mLayoutStamp;
+	aLine.mLayout.clear();
+
+	auto& chars = aLine.mChars;
+	if (mMonospace && std::all_of(chars.begin(), chars.end(), [](char c) { return c >= ' ' && c < 127; }))
+		return;
+
+	aLine.mLayout.resize(chars.size() + 1);
+	float x = 0.0f;
+	for (size_t i = 0; i < chars.size(); )
+	{
+		aLine.mLayout[i] = x;
+		auto c = (uint8_t)chars[i];
+		if (c == '\t')
+		{
+			x = GetNextTabStop(x);
+			++i;
+		}
+		else if (c < 128)
 		{
-			distance = (1.0f + std::floor((1.0f + distance) / (float(mTabSize) * spaceSize))) * (float(mTabSize) * spaceSize);
-			++it;
+			x += mAsciiAdvance[c];
+			++i;
 		}
 		else
 		{
-			auto d = UTF8CharLength(line[it].mChar);
-			char tempCString[7];
-			int i = 0;
-			for (; i < 6 && d-- > 0 && it < (int)line.size(); i++, it++)
-				tempCString[i] = line[it].mChar;
-
-			tempCString[i] = '\0';
-			distance += ImGui::GetFont()->CalcTextSizeA(ImGui::GetFontSize(), FLT_MAX, -1.0f, tempCString, nullptr, nullptr).x;
+			// all bytes of a UTF-8 sequence start at the same x
+			auto end = std::min(chars.size(), i + UTF8CharLength(c));
+			x += mLayoutFont->CalcTextSizeA(mLayoutFontSize, FLT_MAX, -1.0f, chars.data() + i, chars.data() + end).x;
+			for (++i; i < end; ++i)
+				aLine.mLayout[i] = aLine.mLayout[i - 1];
 		}
 	}
+	aLine.mLayout.back() = x;
+}
+
+float TextEditor::GetLineX(int aLine, int aIndex) const
+{
+	auto& line = mLines[aLine];
+	UpdateLineLayout(line);
+	aIndex = std::min(aIndex, (int)line.size());
+	if (line.mLayout.empty())
+		return aIndex * mSpaceSize;
+	return line.mLayout[aIndex];
+}
+
+int TextEditor::GetLineIndexAtX(int aLine, float aX) const
+{
+	auto& line = mLines[aLine];
+	UpdateLineLayout(line);
+	if (aX <= 0.0f || line.empty())
+		return 0;
+
+	if (line.mLayout.empty())
+		return std::min((int)(aX / mSpaceSize), (int)line.size());
+
+	int index = std::max(0, (int)(std::upper_bound(line.mLayout.begin(), line.mLayout.end(), aX) - line.mLayout.begin()) - 1);
+	while (index > 0 && index < (int)line.size() && IsUTFSequence(line.mChars[index]))
+		--index;
+	return std::min(index, (int)line.size());
+}
 
-	return distance;
+float TextEditor::GetNextTabStop(float aX) const
+{
+	const float tabWidth = float(mTabSize) * mSpaceSize;
+	return (1.0f + std::floor((1.0f + aX) / tabWidth)) * tabWidth;
+}
+
+float TextEditor::GetAsciiTextWidth(const char* aText) const
+{
+	float width = 0.0f;
+	for (; *aText; ++aText)
+		width += mAsciiAdvance[*aText & 0x7f];
+	return width;
 }
 
 void TextEditor::EnsureCursorVisible()
@@ -2481,18 +2977,18 @@ TextEditor::UndoRecord::UndoRecord(
 	assert(mRemovedStart <= mRemovedEnd);
 }
 
-void TextEditor::UndoRecord::Undo(TextEditor* aEditor)
+void TextEditor::UndoEntry::Undo(TextEditor* aEditor) const
 {
-	if (!mAdded.empty())
+	if (mAddedLength != 0)
 	{
 		aEditor->DeleteRange(mAddedStart, mAddedEnd);
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 2);
 	}
 
-	if (!mRemoved.empty())
+	if (mRemovedLength != 0)
 	{
 		auto start = mRemovedStart;
-		aEditor->InsertTextAt(start, mRemoved.c_str());
+		aEditor->InsertTextAt(start, aEditor->mUndoText.c_str() + mText);
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 2);
 	}
 
@@ -2501,18 +2997,18 @@ void TextEditor::UndoRecord::Undo(TextEditor* aEditor)
 
 }
 
-void TextEditor::UndoRecord::Redo(TextEditor* aEditor)
+void TextEditor::UndoEntry::Redo(TextEditor* aEditor) const
 {
-	if (!mRemoved.empty())
+	if (mRemovedLength != 0)
 	{
 		aEditor->DeleteRange(mRemovedStart, mRemovedEnd);
 		aEditor->Colorize(mRemovedStart.mLine - 1, mRemovedEnd.mLine - mRemovedStart.mLine + 1);
 	}
 
-	if (!mAdded.empty())
+	if (mAddedLength != 0)
 	{
 		auto start = mAddedStart;
-		aEditor->InsertTextAt(start, mAdded.c_str());
+		aEditor->InsertTextAt(start, aEditor->mUndoText.c_str() + mText + mRemovedLength + 1);
 		aEditor->Colorize(mAddedStart.mLine - 1, mAddedEnd.mLine - mAddedStart.mLine + 1);
 	}
 
@@ -2737,6 +3233,176 @@ static bool TokenizeCStylePunctuation(const char* in_begin, const char* in_end,
 	return false;
 }
 
+// GLSL numbers: 0x1F, 017, 3u, 1.0, .5, 2e-3, 1.5f, 1.0lf. The sign is left to the punctuation.
+static bool TokenizeGlslNumber(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end)
+{
+	const char* p = in_begin;
+	auto isDigit = [](char c) { return c >= '0' && c <= '9'; };
+
+	if (!isDigit(*p) && !(*p == '.' && p + 1 < in_end && isDigit(p[1])))
+		return false;
+
+	if (*p == '0' && p + 1 < in_end && (p[1] == 'x' || p[1] == 'X'))
+	{
+		p += 2;
+		while (p < in_end && (isDigit(*p) || (*p >= 'a' && *p <= 'f') || (*p >= 'A' && *p <= 'F')))
+			p++;
+		if (p < in_end && (*p == 'u' || *p == 'U'))
+			p++;
+		out_begin = in_begin;
+		out_end = p;
+		return true;
+	}
+
+	bool isFloat = false;
+	while (p < in_end && isDigit(*p))
+		p++;
+	if (p < in_end && *p == '.')
+	{
+		isFloat = true;
+		p++;
+		while (p < in_end && isDigit(*p))
+			p++;
+	}
+
+	// only an exponent with digits belongs to the number
+	if (p < in_end && (*p == 'e' || *p == 'E'))
+	{
+		const char* exponent = p + 1;
+		if (exponent < in_end && (*exponent == '+' || *exponent == '-'))
+			exponent++;
+		if (exponent < in_end && isDigit(*exponent))
+		{
+			isFloat = true;
+			p = exponent;
+			while (p < in_end && isDigit(*p))
+				p++;
+		}
+	}
+
+	if (isFloat)
+	{
+		if (p + 1 < in_end && ((p[0] == 'l' && p[1] == 'f') || (p[0] == 'L' && p[1] == 'F')))
+			p += 2;
+		else if (p < in_end && (*p == 'f' || *p == 'F'))
+			p++;
+	}
+	else if (p < in_end && (*p == 'u' || *p == 'U'))
+	{
+		p++;
+	}
+
+	out_begin = in_begin;
+	out_end = p;
+	return true;
+}
+
+// '#' and the directive name. The rest of the line, including continued lines, is marked by
+// the mPreprocessor pass in ColorizeInternal.
+static bool TokenizeGlslPreprocessor(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end)
+{
+	const char* p = in_begin;
+	if (*p != '#')
+		return false;
+
+	p++;
+	while (p < in_end && (*p == ' ' || *p == '\t'))
+		p++;
+	while (p < in_end && ((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '_'))
+		p++;
+
+	out_begin = in_begin;
+	out_end = p;
+	return true;
+}
+
+// Never fails on a non-empty range, so the regex list is not needed at all
+static bool TokenizeGlsl(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end, TextEditor::PaletteIndex& paletteIndex)
+{
+	typedef TextEditor::PaletteIndex PaletteIndex;
+
+	while (in_begin < in_end && (*in_begin == ' ' || *in_begin == '\t'))
+		in_begin++;
+
+	if (in_begin == in_end)
+	{
+		out_begin = in_end;
+		out_end = in_end;
+		paletteIndex = PaletteIndex::Default;
+	}
+	else if (TokenizeGlslPreprocessor(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Preprocessor;
+	else if (TokenizeCStyleString(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::String;
+	else if (TokenizeCStyleIdentifier(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Identifier;
+	else if (TokenizeGlslNumber(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Number;
+	else if (TokenizeCStylePunctuation(in_begin, in_end, out_begin, out_end))
+		paletteIndex = PaletteIndex::Punctuation;
+	else
+	{
+		// stray characters like '\' continuations, '@' or UTF-8 in the middle of code
+		out_begin = in_begin;
+		out_end = std::min(in_end, in_begin + UTF8CharLength(*in_begin));
+		paletteIndex = PaletteIndex::Default;
+	}
+	return true;
+}
+
+static bool ClassifyGlslIdentifier(const char* in_begin, const char* in_end, TextEditor::PaletteIndex& paletteIndex)
+{
+	switch (FindGlslWord(in_begin, in_end - in_begin))
+	{
+	case GlslWord_Keyword:
+		paletteIndex = TextEditor::PaletteIndex::Keyword;
+		return true;
+	case GlslWord_Function:
+	case GlslWord_Variable:
+		paletteIndex = TextEditor::PaletteIndex::KnownIdentifier;
+		return true;
+	default:
+		return false;
+	}
+}
+
+// The regex rules GLSL used before TokenizeGlsl, kept to compare against in BenchmarkGLSLColorize
+static TextEditor::LanguageDefinition GLSLRegex()
+{
+	typedef TextEditor::PaletteIndex PaletteIndex;
+
+	TextEditor::LanguageDefinition langDef = TextEditor::LanguageDefinition::GLSL();
+	langDef.mTokenize = nullptr;
+	langDef.mClassifyIdentifier = nullptr;
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[ \\t]*#[ \\t]*[a-zA-Z_]+", PaletteIndex::Preprocessor));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("L?\\\"(\\\\.|[^\\\"])*\\\"", PaletteIndex::String));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("\\'\\\\?[^\\']\\'", PaletteIndex::CharLiteral));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?([0-9]+([.][0-9]*)?|[.][0-9]+)([eE][+-]?[0-9]+)?[fF]?", PaletteIndex::Number));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?[0-9]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[0-7]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[xX][0-9a-fA-F]+[uU]?[lL]?[lL]?", PaletteIndex::Number));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[a-zA-Z_][a-zA-Z0-9_]*", PaletteIndex::Identifier));
+	langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[\\[\\]\\{\\}\\!\\%\\^\\&\\*\\(\\)\\-\\+\\=\\~\\|\\<\\>\\?\\/\\;\\,\\.]", PaletteIndex::Punctuation));
+	return langDef;
+}
+
+float TextEditor::MeasureColorize(const std::string& aText, const LanguageDefinition& aLanguageDef)
+{
+	TextEditor editor;
+	editor.SetLanguageDefinition(aLanguageDef);
+	editor.SetText(aText);
+
+	auto start = std::chrono::steady_clock::now();
+	editor.ColorizeRange(0, (int)editor.mLines.size());
+	return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void TextEditor::BenchmarkGLSLColorize(const std::string& aText, float& aNativeMs, float& aRegexMs)
+{
+	aNativeMs = MeasureColorize(aText, LanguageDefinition::GLSL());
+	aRegexMs = MeasureColorize(aText, GLSLRegex());
+}
+
 const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::CPlusPlus()
 {
 	static bool inited = false;
@@ -2884,34 +3550,23 @@ const TextEditor::LanguageDefinition& TextEditor::LanguageDefinition::GLSL()
 	static LanguageDefinition langDef;
 	if (!inited)
 	{
-		static const char* const keywords[] = {
-			"auto", "break", "case", "char", "const", "continue", "default", "do", "double", "else", "enum", "extern", "float", "for", "goto", "if", "inline", "int", "long", "register", "restrict", "return", "short",
-			"signed", "sizeof", "static", "struct", "switch", "typedef", "union", "unsigned", "void", "volatile", "while", "_Alignas", "_Alignof", "_Atomic", "_Bool", "_Complex", "_Generic", "_Imaginary",
-			"_Noreturn", "_Static_assert", "_Thread_local", "vec2", "vec3", "vec4", "uint", "bvec2", "bvec3", "bvec4", "ivec2", "ivec3", "ivec4", "uvec2", "uvec3", "uvec4", "dvec2", "dvec3", "dvec4", "mat2", "mat3", "mat4", "mat2x2", "mat3x2", "mat4x2", "mat2x3", "mat3x3", "mat4x3", "mat2x4", "mat3x4", "mat4x4"
-		};
-		for (auto& k : keywords)
-			langDef.mKeywords.insert(k);
-
-		static const char* const identifiers[] = {
-			"abort", "abs", "acos", "asin", "atan", "atexit", "atof", "atoi", "atol", "ceil", "clock", "cosh", "ctime", "div", "exit", "fabs", "floor", "fmod", "getchar", "getenv", "isalnum", "isalpha", "isdigit", "isgraph",
-			"ispunct", "isspace", "isupper", "kbhit", "log10", "log2", "log", "memcmp", "modf", "pow", "putchar", "putenv", "puts", "rand", "remove", "rename", "sinh", "sqrt", "srand", "strcat", "strcmp", "strerror", "time", "tolower", "toupper"
-		};
-		for (auto& k : identifiers)
+		// the sets are still filled for the hover tooltips, colorizing goes through GlslWords.h
+		for (auto& word : glslWords)
 		{
-			Identifier id;
-			id.mDeclaration = "Built-in function";
-			langDef.mIdentifiers.insert(std::make_pair(std::string(k), id));
+			if (word.kind == GlslWord_Keyword)
+			{
+				langDef.mKeywords.insert(word.text);
+			}
+			else
+			{
+				Identifier id;
+				id.mDeclaration = word.kind == GlslWord_Function ? "Built-in function" : "Built-in variable";
+				langDef.mIdentifiers.insert(std::make_pair(std::string(word.text), id));
+			}
 		}
 
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[ \\t]*#[ \\t]*[a-zA-Z_]+", PaletteIndex::Preprocessor));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("L?\\\"(\\\\.|[^\\\"])*\\\"", PaletteIndex::String));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("\\'\\\\?[^\\']\\'", PaletteIndex::CharLiteral));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?([0-9]+([.][0-9]*)?|[.][0-9]+)([eE][+-]?[0-9]+)?[fF]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[+-]?[0-9]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[0-7]+[Uu]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("0[xX][0-9a-fA-F]+[uU]?[lL]?[lL]?", PaletteIndex::Number));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[a-zA-Z_][a-zA-Z0-9_]*", PaletteIndex::Identifier));
-		langDef.mTokenRegexStrings.push_back(std::make_pair<std::string, PaletteIndex>("[\\[\\]\\{\\}\\!\\%\\^\\&\\*\\(\\)\\-\\+\\=\\~\\|\\<\\>\\?\\/\\;\\,\\.]", PaletteIndex::Punctuation));
+		langDef.mTokenize = TokenizeGlsl;
+		langDef.mClassifyIdentifier = ClassifyGlslIdentifier;
 
 		langDef.mCommentStart = "/*";
 		langDef.mCommentEnd = "*/";
@@ -8,6 +8,9 @@
 #include <unordered_map>
 #include <map>
 #include <regex>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "../imgui/imgui.h"
 
 class TextEditor
@@ -31,6 +34,7 @@ public:
 		Cursor,
 		Selection,
 		ErrorMarker,
+		WarningMarker,
 		Breakpoint,
 		LineNumber,
 		CurrentLineFill,
@@ -125,14 +129,38 @@ public:
 		std::string mDeclaration;
 	};
 
+	enum class DiagnosticSeverity
+	{
+		Error,
+		Warning,
+	};
+
+	struct Diagnostic
+	{
+		int mLine = 0;			// 1 based, 0 for none
+		int mStart = -1;		// character index the squiggle starts at, -1 for none
+		int mEnd = -1;			// one past its last character, or -1 for the word at mStart
+		DiagnosticSeverity mSeverity = DiagnosticSeverity::Error;
+		std::string mMessage;
+	};
+
+	// Owned by whoever produces the diagnostics and shared with the editors showing them. Bump
+	// mVersion after changing mEntries, editors only rebuild their per-line lookup when it moves.
+	struct Diagnostics
+	{
+		std::vector<Diagnostic> mEntries;
+		uint32_t mVersion = 1;
+	};
+
 	typedef std::string String;
 	typedef std::unordered_map<std::string, Identifier> Identifiers;
 	typedef std::unordered_set<std::string> Keywords;
-	typedef std::map<int, std::string> ErrorMarkers;
+	typedef std::multimap<int, int> DiagnosticLines;	// line to index in Diagnostics::mEntries
 	typedef std::unordered_set<int> Breakpoints;
 	typedef std::array<ImU32, (unsigned)PaletteIndex::Max> Palette;
 	typedef uint8_t Char;
 
+	// A character together with its color and comment flags, unpacked from a Line
 	struct Glyph
 	{
 		Char mChar;
@@ -145,7 +173,77 @@ public:
 			mComment(false), mMultiLineComment(false), mPreprocessor(false) {}
 	};
 
-	typedef std::vector<Glyph> Line;
+	// Characters of a line as one plain string with the color and comment flags of each of them
+	// in a parallel byte array, 2 bytes per character instead of a padded Glyph. The lexer and
+	// GetText read mChars directly.
+	class Line
+	{
+	public:
+		enum : uint8_t
+		{
+			ColorMask = 0x1f,
+			CommentFlag = 1 << 5,
+			MultiLineCommentFlag = 1 << 6,
+			PreprocessorFlag = 1 << 7
+		};
+
+		std::string mChars;	// edit through the members below, they drop the layout
+		std::vector<uint8_t> mAttributes;
+
+		// x of each character from the line start in pixels, plus the line width at the end,
+		// filled on demand by TextEditor::UpdateLineLayout. Stays empty when the line is printable
+		// ASCII without tabs in a monospace font, x is then the index times the character advance.
+		mutable std::vector<float> mLayout;
+		mutable uint32_t mLayoutStamp = 0;	// TextEditor::mLayoutStamp it was built with, 0 if stale
+
+		size_t size() const { return mChars.size(); }
+		bool empty() const { return mChars.empty(); }
+		void reserve(size_t aSize) { mChars.reserve(aSize); mAttributes.reserve(aSize); }
+
+		Glyph operator[](size_t aIndex) const
+		{
+			uint8_t attributes = mAttributes[aIndex];
+			Glyph glyph((Char)mChars[aIndex], (PaletteIndex)(attributes & ColorMask));
+			glyph.mComment = (attributes & CommentFlag) != 0;
+			glyph.mMultiLineComment = (attributes & MultiLineCommentFlag) != 0;
+			glyph.mPreprocessor = (attributes & PreprocessorFlag) != 0;
+			return glyph;
+		}
+
+		void push_back(const Glyph& aGlyph) { mChars.push_back((char)aGlyph.mChar); mAttributes.push_back(Pack(aGlyph)); mLayoutStamp = 0; }
+		void insert(size_t aIndex, const Glyph& aGlyph)
+		{
+			mChars.insert(mChars.begin() + aIndex, (char)aGlyph.mChar);
+			mAttributes.insert(mAttributes.begin() + aIndex, Pack(aGlyph));
+			mLayoutStamp = 0;
+		}
+		// Copies [aFrom, aTo) of aOther to aIndex
+		void insert(size_t aIndex, const Line& aOther, size_t aFrom, size_t aTo)
+		{
+			mChars.insert(mChars.begin() + aIndex, aOther.mChars.begin() + aFrom, aOther.mChars.begin() + aTo);
+			mAttributes.insert(mAttributes.begin() + aIndex, aOther.mAttributes.begin() + aFrom, aOther.mAttributes.begin() + aTo);
+			mLayoutStamp = 0;
+		}
+		void erase(size_t aFrom, size_t aTo)
+		{
+			mChars.erase(mChars.begin() + aFrom, mChars.begin() + aTo);
+			mAttributes.erase(mAttributes.begin() + aFrom, mAttributes.begin() + aTo);
+			mLayoutStamp = 0;
+		}
+
+		PaletteIndex GetColorIndex(size_t aIndex) const { return (PaletteIndex)(mAttributes[aIndex] & ColorMask); }
+		void SetColorIndex(size_t aIndex, PaletteIndex aColor) { mAttributes[aIndex] = (mAttributes[aIndex] & ~ColorMask) | (uint8_t)aColor; }
+		void SetFlag(size_t aIndex, uint8_t aFlag, bool aValue) { mAttributes[aIndex] = aValue ? mAttributes[aIndex] | aFlag : mAttributes[aIndex] & ~aFlag; }
+
+	private:
+		static uint8_t Pack(const Glyph& aGlyph)
+		{
+			return (uint8_t)aGlyph.mColorIndex | (aGlyph.mComment ? CommentFlag : 0) |
+				(aGlyph.mMultiLineComment ? MultiLineCommentFlag : 0) | (aGlyph.mPreprocessor ? PreprocessorFlag : 0);
+		}
+	};
+	static_assert((int)PaletteIndex::Max <= Line::ColorMask + 1, "PaletteIndex does not fit Line::ColorMask");
+
 	typedef std::vector<Line> Lines;
 
 	struct LanguageDefinition
@@ -153,6 +251,8 @@ public:
 		typedef std::pair<std::string, PaletteIndex> TokenRegexString;
 		typedef std::vector<TokenRegexString> TokenRegexStrings;
 		typedef bool(*TokenizeCallback)(const char* in_begin, const char* in_end, const char*& out_begin, const char*& out_end, PaletteIndex& paletteIndex);
+		// Sets paletteIndex for a keyword or known identifier, returns false for any other name
+		typedef bool(*ClassifyCallback)(const char* in_begin, const char* in_end, PaletteIndex& paletteIndex);
 
 		std::string mName;
 		Keywords mKeywords;
@@ -163,13 +263,15 @@ public:
 		bool mAutoIndentation;
 
 		TokenizeCallback mTokenize;
+		// optional, replaces the mKeywords and mIdentifiers lookups outside of preprocessor lines
+		ClassifyCallback mClassifyIdentifier;
 
 		TokenRegexStrings mTokenRegexStrings;
 
 		bool mCaseSensitive;
 
 		LanguageDefinition()
-			: mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mCaseSensitive(true)
+			: mPreprocChar('#'), mAutoIndentation(true), mTokenize(nullptr), mClassifyIdentifier(nullptr), mCaseSensitive(true)
 		{
 		}
 
@@ -191,12 +293,15 @@ public:
 	const Palette& GetPalette() const { return mPaletteBase; }
 	void SetPalette(const Palette& aValue);
 
-	void SetErrorMarkers(const ErrorMarkers& aMarkers) { mErrorMarkers = aMarkers; }
+	// aDiagnostics has to outlive the editor or be replaced, 0 shows none
+	void SetDiagnostics(const Diagnostics* aDiagnostics) { mDiagnostics = aDiagnostics; mDiagnosticsVersion = 0; mDiagnosticLines.clear(); }
 	void SetBreakpoints(const Breakpoints& aMarkers) { mBreakpoints = aMarkers; }
 
 	void Render(const char* aTitle, bool* p_open = 0);
 	void SetText(const std::string& aText);
 	std::string GetText() const;
+	// Same text as GetText, written into aText so a buffer kept by the caller is reused
+	void GetText(std::string& aText) const;
 
 	void SetTextLines(const std::vector<std::string>& aLines);
 	std::vector<std::string> GetTextLines() const;
@@ -214,6 +319,10 @@ public:
 
 	bool IsColorizerEnabled() const { return mColorizerEnabled; }
 	void SetColorizerEnable(bool aValue);
+	// time spent colorizing during the last Render() call
+	float GetColorizeMilliseconds() const { return mColorizeMilliseconds; }
+	// Called from the colorize thread when colors are ready, e.g. to wake an event loop
+	void SetColorizeNotify(void (*aNotify)()) { mColorizeNotify = aNotify; }
 
 	Coordinates GetCursorPosition() const { return GetActualCursorCoordinates(); }
 	void SetCursorPosition(const Coordinates& aPosition);
@@ -261,6 +370,16 @@ public:
 	bool CanRedo() const;
 	void Undo(int aSteps = 1);
 	void Redo(int aSteps = 1);
+	// The oldest undo steps are dropped once the history takes more than this many bytes. The
+	// last step is always kept, however large.
+	void SetUndoMemoryBudget(size_t aBytes);
+	size_t GetUndoMemoryBudget() const { return mUndoMemoryBudget; }
+	size_t GetUndoMemoryUsage() const;
+
+	// Time to tokenize aText in one go, without the incremental spreading over frames
+	static float MeasureColorize(const std::string& aText, const LanguageDefinition& aLanguageDef);
+	// Native GLSL lexer against the regex rules it replaced
+	static void BenchmarkGLSLColorize(const std::string& aText, float& aNativeMs, float& aRegexMs);
 
 	static const Palette& GetDarkPalette();
 	static const Palette& GetLightPalette();
@@ -294,9 +413,6 @@ private:
 			TextEditor::EditorState& aBefore,
 			TextEditor::EditorState& aAfter);
 
-		void Undo(TextEditor* aEditor);
-		void Redo(TextEditor* aEditor);
-
 		std::string mAdded;
 		Coordinates mAddedStart;
 		Coordinates mAddedEnd;
@@ -309,13 +425,89 @@ private:
 		EditorState mAfter;
 	};
 
-	typedef std::vector<UndoRecord> UndoBuffer;
+	// An UndoRecord as kept in the history. Its removed and added text are stored one after the
+	// other in mUndoText, each NUL terminated, so the history is one buffer and not two strings
+	// per step.
+	struct UndoEntry
+	{
+		size_t mText;	// offset into mUndoText
+		size_t mRemovedLength;
+		size_t mAddedLength;
+		bool mCanMerge;	// typing or deleting single characters, see MergeUndo
+
+		Coordinates mAddedStart;
+		Coordinates mAddedEnd;
+		Coordinates mRemovedStart;
+		Coordinates mRemovedEnd;
+
+		EditorState mBefore;
+		EditorState mAfter;
+
+		void Undo(TextEditor* aEditor) const;
+		void Redo(TextEditor* aEditor) const;
+	};
+
+	typedef std::vector<UndoEntry> UndoBuffer;
+
+	// What the comment pass carries from the end of one line into the next
+	struct LineState
+	{
+		bool mWithinString = false;
+		bool mWithinComment = false;
+		bool mWithinSingleLineComment = false;
+		bool mWithinPreproc = false;
+		bool mFirstChar = true;
+		bool mConcatenate = false;	// the line before ended in '\'
+
+		bool operator==(const LineState& o) const
+		{
+			return mWithinString == o.mWithinString && mWithinComment == o.mWithinComment &&
+				mWithinSingleLineComment == o.mWithinSingleLineComment && mWithinPreproc == o.mWithinPreproc &&
+				mFirstChar == o.mFirstChar && mConcatenate == o.mConcatenate;
+		}
+		bool operator!=(const LineState& o) const { return !(*this == o); }
+	};
+	typedef std::vector<LineState> LineStates;
+
+	// Copy of some lines for the colorize thread, packed into one buffer and tagged with the text
+	// version it was taken at. The colors only go back into mLines if nothing was edited in the
+	// meantime, or the line still reads the same.
+	struct ColorizeJob
+	{
+		uint64_t mVersion = 0;
+		int mRangeBegin = -1, mRangeEnd = -1;	// part of the color range it covers, -1 for the visible lines
+		std::vector<int> mLineIndices;
+		std::vector<int> mLineStarts;	// into mChars and mAttributes
+		std::string mChars;
+		std::vector<uint8_t> mAttributes;
+
+		int GetLineSize(size_t aLine) const
+		{
+			return (aLine + 1 < mLineStarts.size() ? mLineStarts[aLine + 1] : (int)mChars.size()) - mLineStarts[aLine];
+		}
+	};
+	typedef std::vector<ColorizeJob> ColorizeJobs;
 
 	void ProcessInputs();
 	void Colorize(int aFromLine = 0, int aCount = -1);
 	void ColorizeRange(int aFromLine = 0, int aToLine = 0);
 	void ColorizeInternal();
+	void ColorizeLine(const char* aChars, uint8_t* aAttributes, int aSize, std::cmatch& aResults, std::string& aId) const;
+	void AddColorizeJobLine(ColorizeJob& aJob, int aIndex) const;
+	void PostColorizeJobs();
+	void ApplyColorizeResults();
+	void ColorizeWorker();
+	void StopColorizeWorker();
+	void CheckComments(int aFromLine, int aToLine);
 	float TextDistanceToLineStart(const Coordinates& aFrom) const;
+	void UpdateLayoutMetrics();
+	void UpdateDiagnostics();
+	void DrawDiagnostics(int aLineNo, const ImVec2& aLineStart, const ImVec2& aTextStart, float aLineEndX);
+	void UpdateLineLayout(const Line& aLine) const;
+	float GetLineX(int aLine, int aIndex) const;
+	int GetLineIndexAtX(int aLine, float aX) const;
+	float GetNextTabStop(float aX) const;
+	float GetAsciiTextWidth(const char* aText) const;
 	void EnsureCursorVisible();
 	int GetPageSize() const;
 	std::string GetText(const Coordinates& aStart, const Coordinates& aEnd) const;
@@ -325,6 +517,9 @@ private:
 	void DeleteRange(const Coordinates& aStart, const Coordinates& aEnd);
 	int InsertTextAt(Coordinates& aWhere, const char* aValue);
 	void AddUndo(UndoRecord& aValue);
+	static bool IsMergeableUndo(const UndoRecord& aValue);
+	bool MergeUndo(UndoEntry& aLast, const UndoRecord& aValue);
+	void TrimUndo();
 	Coordinates ScreenPosToCoordinates(const ImVec2& aPosition) const;
 	Coordinates FindWordStart(const Coordinates& aFrom) const;
 	Coordinates FindWordEnd(const Coordinates& aFrom) const;
@@ -337,6 +532,8 @@ private:
 	void RemoveLine(int aStart, int aEnd);
 	void RemoveLine(int aIndex);
 	Line& InsertLine(int aIndex);
+	void InsertLines(int aIndex, int aCount);
+	void ShiftColorRange(int aIndex, int aCount);
 	void EnterCharacter(ImWchar aChar, bool aShift);
 	void Backspace();
 	void DeleteSelection();
@@ -353,6 +550,8 @@ private:
 	EditorState mState;
 	UndoBuffer mUndoBuffer;
 	int mUndoIndex;
+	std::string mUndoText;	// text of the mUndoBuffer entries, in the same order
+	size_t mUndoMemoryBudget;
 
 	int mTabSize;
 	bool mOverwrite;
@@ -362,6 +561,7 @@ private:
 	bool mScrollToTop;
 	bool mTextChanged;
 	bool mColorizerEnabled;
+	float mColorizeMilliseconds;
 	float mTextStart;                   // position (in pixels) where a code line starts relative to the left of the TextEditor.
 	int  mLeftMargin;
 	bool mCursorPositionChanged;
@@ -374,15 +574,43 @@ private:
 
 	Palette mPaletteBase;
 	Palette mPalette;
+	Palette mPreprocPalette;
+	float mPaletteAlpha;	// style alpha mPalette was built with
 	LanguageDefinition mLanguageDefinition;
 	RegexList mRegexList;
 
 	bool mCheckComments;
+	int mCheckCommentsMin, mCheckCommentsMax;	// lines edited since the last comment pass
+	LineStates mLineStates;	// state at the start of each line, plus one past the last line
+	uint64_t mTextVersion;	// bumped by every edit, see CheckComments
+	int mVisibleLineMin, mVisibleLineMax;	// from the last Render, colorized before the rest
+	int mColorizePending;	// jobs posted whose result has not come back yet
+
+	// Tokenizing runs on its own thread, started on first use. It only reads the language
+	// definition, so SetLanguageDefinition stops it before replacing that.
+	std::thread mColorizeThread;
+	std::mutex mColorizeMutex;
+	std::condition_variable mColorizeWake;
+	void (*mColorizeNotify)();
+	// guarded by mColorizeMutex
+	ColorizeJobs mColorizeRequests;
+	ColorizeJobs mColorizeResults;
+	bool mColorizeQuit;
 	Breakpoints mBreakpoints;
-	ErrorMarkers mErrorMarkers;
+	const Diagnostics* mDiagnostics;
+	uint32_t mDiagnosticsVersion;	// of mDiagnostics that mDiagnosticLines was built from
+	DiagnosticLines mDiagnosticLines;	// moves with the text between rebuilds
 	ImVec2 mCharAdvance;
+
+	// Font metrics the Line::mLayout caches were built with, bumping mLayoutStamp drops them all
+	ImFont* mLayoutFont;
+	float mLayoutFontSize;
+	int mLayoutTabSize;
+	uint32_t mLayoutStamp;
+	float mSpaceSize;
+	float mAsciiAdvance[128];
+	bool mMonospace;	// all printable ASCII characters have the same advance
 	Coordinates mInteractiveStart, mInteractiveEnd;
-	std::string mLineBuffer;
 	uint64_t mStartTime;
 
 	float mLastClick;